@@ -5,7 +5,9 @@
 #include "kernel/yosys.h"
 #include "kernel/yosys_common.h"
 #include "tmrx_constants.h"
+#include "tmrx_module_matcher.h"
 #include "toml11/toml.hpp"
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -21,11 +23,19 @@ enum class TmrMode {
 
 enum class TmrVoter { Default, Custom };
 
+enum class FfVoterPlacement { All, FeedbackCut };
+
+enum class TimingModel { None, LogicDepth, Liberty };
+
 // String conversion helpers
 std::optional<TmrMode> parseTmrMode(const std::string &str);
 std::string tmrModeToString(TmrMode mode);
 std::optional<TmrVoter> parseTmrVoter(const std::string &str);
 std::string tmrVoterToString(TmrVoter voter);
+std::optional<FfVoterPlacement> parseFfVoterPlacement(const std::string &str);
+std::string ffVoterPlacementToString(FfVoterPlacement placement);
+std::optional<TimingModel> parseTimingModel(const std::string &str);
+std::string timingModelToString(TimingModel model);
 
 // TOML parsing helpers
 template <typename T>
@@ -41,6 +51,15 @@ template <typename T> void applyIfPresent(T &dest, const std::optional<T> &src);
 std::string poolToString(const Yosys::pool<Yosys::RTLIL::IdString> &pool);
 std::string boolToString(bool val);
 
+struct Config;
+
+// Serialized form of `c`: two configs have the same key exactly when they are
+// equal.
+std::string configKey(const Config &c);
+
+// Resolved configuration of one module. ConfigManager interns and caches
+// these, so every field must also be listed in visitConfigFields() in
+// config_manager.cc.
 struct Config {
 
     TmrMode tmrMode;
@@ -54,17 +73,28 @@ struct Config {
     std::string tmrVoterResetNet; // parent wire to drive voter reset (default: first reset port)
 
     bool tmrVoterSafeMode;
+    bool tmrVoterWordLevel;
 
     bool preserveModulePorts;
     bool preventRenaming;
 
     bool insertVoterBeforeFf;
     bool insertVoterAfterFf;
+    // Which flip-flops get voters when insertVoterAfterFf is set: every one,
+    // or only a cut set that breaks every register feedback loop.
+    FfVoterPlacement ffVoterPlacement;
+    // Delay estimate used to choose, per flip-flop, between voting its inputs
+    // and its outputs. None keeps the placement given by the two flags above.
+    TimingModel timingModel;
+    std::string timingLibertyFile;
 
     bool tmrModeFullModuleInsertVoterBeforeModules;
     bool tmrModeFullModuleInsertVoterAfterModules;
     bool tmrModeFullModuleInsertVoterOnClockNets;
     bool tmrModeFullModuleInsertVoterOnResetNets;
+    // Let the three worker instances share one module definition instead of
+    // cloning the worker and its submodule hierarchy once per TMR path.
+    bool tmrModeFullModuleSharedWorker;
 
     Yosys::pool<Yosys::RTLIL::IdString> clockPortNames;
     bool expandClock;
@@ -89,6 +119,14 @@ struct Config {
     // 1-bit output port named `tmrx_err_o` (uniquified to avoid collisions)
     // and connect the aggregated voter error signals to it.
     bool autoErrorPort;
+
+    // Maximum number of error signals OR'd by one cell of the error
+    // aggregation tree. 0 means a single $reduce_or over all errors.
+    int errorTreeFanIn;
+
+    // Insert a register stage after every N levels of the error aggregation
+    // tree, clocked from the module's clock port. 0 disables registering.
+    int errorRegisterLevels;
 };
 
 struct ConfigPart {
@@ -103,17 +141,22 @@ struct ConfigPart {
     std::optional<std::string> tmrVoterClockNet;
     std::optional<std::string> tmrVoterResetNet;
     std::optional<bool> tmrVoterSafeMode;
+    std::optional<bool> tmrVoterWordLevel;
 
     std::optional<bool> preserveModulePorts;
     std::optional<bool> preventRenaming;
 
     std::optional<bool> insertVoterBeforeFf;
     std::optional<bool> insertVoterAfterFf;
+    std::optional<FfVoterPlacement> ffVoterPlacement;
+    std::optional<TimingModel> timingModel;
+    std::optional<std::string> timingLibertyFile;
 
     std::optional<bool> tmrModeFullModuleInsertVoterBeforeModules;
     std::optional<bool> tmrModeFullModuleInsertVoterAfterModules;
     std::optional<bool> tmrModeFullModuleInsertVoterOnClockNets;
     std::optional<bool> tmrModeFullModuleInsertVoterOnResetNets;
+    std::optional<bool> tmrModeFullModuleSharedWorker;
 
     std::optional<Yosys::pool<Yosys::RTLIL::IdString>> clockPortNames;
     std::optional<bool> expandClock;
@@ -131,54 +174,139 @@ struct ConfigPart {
 
     std::optional<std::string> errorPortName;
     std::optional<bool> autoErrorPort;
+    std::optional<int> errorTreeFanIn;
+    std::optional<int> errorRegisterLevels;
 };
 
+struct TimingLibrary;
+
 struct ConfigManager {
   private:
     void loadGlobalDefaultCfg();
     void loadDefaultGroupsCfg();
-    void loadCustomVoters(Yosys::RTLIL::Design *design);
-    void validateCfg(Yosys::RTLIL::Design *design);
+    void loadConfigFile() const;
+    void loadCustomVoter(Yosys::RTLIL::IdString modName, const Config &c);
+    void loadTimingLibrary(Yosys::RTLIL::IdString modName, const Config &c);
+    const Config *validateCfg(const Yosys::RTLIL::Module *module, const Config *c) const;
+    void cfgWarning(const std::string &message) const;
 
     // Attribute parsing helpers
     std::string getStringAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr,
-                                     const std::string &def);
-    bool getBoolAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr, bool def);
-    int getIntAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr, int def);
+                                     const std::string &def) const;
+    bool getBoolAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr,
+                            bool def) const;
+    int getIntAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr,
+                          int def) const;
     std::optional<std::string> getStringAttrValue(const Yosys::RTLIL::Module *mod,
-                                                  const std::string &attr);
-    std::optional<bool> getBoolAttrValue(const Yosys::RTLIL::Module *mod, const std::string &attr);
-    std::optional<int> getIntAttrValue(const Yosys::RTLIL::Module *mod, const std::string &attr);
-    std::optional<std::vector<std::string>> getStringListAttrValue(const Yosys::RTLIL::Module *mod,
-                                                                   const std::string &attr);
+                                                  const std::string &attr) const;
+    std::optional<bool> getBoolAttrValue(const Yosys::RTLIL::Module *mod,
+                                         const std::string &attr) const;
+    std::optional<int> getIntAttrValue(const Yosys::RTLIL::Module *mod,
+                                       const std::string &attr) const;
+    std::optional<std::vector<std::string>>
+    getStringListAttrValue(const Yosys::RTLIL::Module *mod, const std::string &attr) const;
     std::optional<Yosys::pool<Yosys::RTLIL::IdString>>
-    parseAttrIdStringPool(const Yosys::RTLIL::Module *mod, const std::string &attr);
+    parseAttrIdStringPool(const Yosys::RTLIL::Module *mod, const std::string &attr) const;
 
     // Config parsing and assembly
-    ConfigPart parseConfig(const toml::value &t);
-    ConfigPart parseModuleAnnotations(const Yosys::RTLIL::Module *mod);
-    Config assembleConfig(std::vector<ConfigPart> parts, Config def);
+    ConfigPart parseConfig(const toml::value &t) const;
+    ConfigPart parseModuleAnnotations(const Yosys::RTLIL::Module *mod) const;
+    Config assembleConfig(std::vector<ConfigPart> parts, Config def) const;
+    const Config *resolveConfig(Yosys::RTLIL::Module *mod) const;
+
+    // Resolved configs are interned: modules with equal configs share one
+    // immutable instance and map to its index. Changing the config of a
+    // module interns the changed copy and leaves the shared instance alone.
+    using ConfigId = size_t;
+    ConfigId internConfig(const Config &cfg) const;
+    const Config *setModuleConfig(Yosys::RTLIL::IdString modName, const Config &cfg) const;
+
+    // On-disk cache of the resolved configs of all design modules
+    std::string configCacheKey(const std::string &configFile) const;
+    bool readConfigCache();
+    void writeConfigCache();
 
     // Config assembly helpers
-    void appendGroupConfigs(
-        std::vector<ConfigPart> &cfgParts,
-        const Yosys::dict<Yosys::RTLIL::IdString, std::vector<std::string>> &groupAssignments,
-        Yosys::RTLIL::IdString lookupName, Yosys::RTLIL::IdString logName);
+    const std::vector<std::string> &attributeGroups(Yosys::RTLIL::IdString modName) const;
+    void appendGroupConfig(std::vector<ConfigPart> &cfgParts, const std::string &groupName,
+                           Yosys::RTLIL::IdString logName) const;
+    void appendGroupConfigs(std::vector<ConfigPart> &cfgParts, Yosys::RTLIL::IdString lookupName,
+                            Yosys::RTLIL::IdString logName) const;
     void appendConfigIfPresent(std::vector<ConfigPart> &cfgParts,
                                const Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> &cfgMap,
-                               Yosys::RTLIL::IdString key);
-
-    Config globalCfg;
-
-    Yosys::dict<std::string, ConfigPart> groupCfg;
-    Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> moduleCfgs;
-    Yosys::dict<Yosys::RTLIL::IdString, Config> finalModuleCfgs;
-    Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> specificModuleCfgs;
-    Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> moduleAttrCfgs;
+                               Yosys::RTLIL::IdString key) const;
+
+    Yosys::RTLIL::Design *design;
+    // Modules present when the config was loaded. Modules TMRX adds later
+    // (clones, wrappers, workers, voters) resolve to the global config.
+    Yosys::pool<Yosys::RTLIL::IdString> designModules;
+
+    // Cache file for -config-cache, empty if disabled, and whether the
+    // configs were loaded from it.
+    std::string cachePath;
+    std::string cacheKey;
+    bool cacheHit = false;
+
+    // Warnings of validateCfg in the order they were printed; stored in the
+    // config cache and printed again when it hits.
+    mutable std::vector<std::string> cfgWarnings;
+
+    // The TOML config file. On a config cache hit it is only parsed if a
+    // module the cache does not cover is resolved, so the state read from it
+    // is filled in lazily.
+    std::string configFile;
+    mutable bool configFileLoaded = false;
+
+    mutable Config globalCfg;
+    mutable ConfigPart globalConfigPart;
+
+    mutable Yosys::dict<std::string, ConfigPart> groupCfg;
+    mutable Yosys::dict<Yosys::RTLIL::IdString, std::vector<std::string>> groupAssignments;
+    mutable Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> moduleCfgs;
+    mutable Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> specificModuleCfgs;
+
+    // [module."<glob>"] and [match."<regex>"] scopes in precedence order; the
+    // index of an entry is its pattern index in `moduleMatcher`.
+    struct PatternScope {
+        std::string pattern;
+        PatternSyntax syntax;
+        ConfigPart cfg;
+        std::vector<std::string> groups;
+    };
+    mutable std::vector<PatternScope> patternCfgs;
+    mutable ModuleMatcher moduleMatcher;
+
+    // Resolved on first use by getConfig and memoized.
+    mutable std::vector<std::unique_ptr<const Config>> internedCfgs;
+    mutable Yosys::dict<std::string, ConfigId> internedCfgIds;
+    mutable Yosys::dict<Yosys::RTLIL::IdString, ConfigId> moduleCfgIds;
+    mutable Yosys::dict<Yosys::RTLIL::IdString, std::vector<std::string>> attrGroupAssignments;
+    mutable bool warnedExpandClock = false;
+    mutable bool warnedExpandReset = false;
+
+    Yosys::pool<std::string> loadedVoterFiles;
+    Yosys::pool<Yosys::RTLIL::IdString> exemptedVoterTemplates;
+    Yosys::pool<std::string> warnedWordLevelVoters;
+
+    // Liberty files of the Liberty timing model, each read once per run.
+    Yosys::dict<std::string, std::shared_ptr<const TimingLibrary>> timingLibraries;
 
   public:
-    ConfigManager(Yosys::RTLIL::Design *design, const std::string &configFile);
+    // With a non-empty `cacheDir`, the resolved configs of the design modules
+    // are loaded from a cache file there if one matches the config file, the
+    // modules' TMRX attributes, the plugin build and the cache format; the
+    // TOML is then only parsed for modules the cache does not cover.
+    ConfigManager(Yosys::RTLIL::Design *design, const std::string &configFile,
+                  const std::string &cacheDir = "");
+
+    // Resolve and validate the configs of the modules that are about to be
+    // expanded, and load the custom voters and liberty files they use. Must
+    // run before any module is expanded: loading a voter runs passes on the
+    // whole design. Writes the config cache when it is enabled and missed.
+    void resolveConfigs(const std::vector<Yosys::RTLIL::Module *> &modules);
+
     const Config *getConfig(Yosys::RTLIL::Module *mod) const;
+    const TimingLibrary *getTimingLibrary(const std::string &path) const;
     std::string getConfigAsString(Yosys::RTLIL::Module *mod) const;
 };
 
@@ -15,14 +15,4 @@
 #include <utility>
 #include <vector>
 
-YOSYS_NAMESPACE_BEGIN
-
-namespace TMRX {
-
-extern dict<RTLIL::IdString, pool<std::string>> ffSources;
-
-} // namespace TMRX
-
-YOSYS_NAMESPACE_END
-
 #endif
@@ -14,6 +14,7 @@ constexpr const char cfg_global_scope_name[] = "global";
 constexpr const char cfg_group_scope_name[] = "group";
 constexpr const char cfg_module_scope_name[] = "module";
 constexpr const char cfg_specific_module_scope_name[] = "specific_module";
+constexpr const char cfg_match_scope_name[] = "match";
 constexpr const char cfg_logic_scope_name[] = "logic";
 constexpr const char cfg_full_module_scope_name[] = "full_module";
 constexpr const char cfg_groups_key_name[] = "groups";
@@ -27,6 +28,7 @@ constexpr const char cfg_tmr_voter_reset_port_name_key_name[] = "tmr_voter_reset
 constexpr const char cfg_tmr_voter_clock_net_key_name[] = "tmr_voter_clock_net";
 constexpr const char cfg_tmr_voter_reset_net_key_name[] = "tmr_voter_reset_net";
 constexpr const char cfg_tmr_voter_safe_mode_key_name[] = "tmr_voter_safe_mode";
+constexpr const char cfg_tmr_voter_word_level_key_name[] = "tmr_voter_word_level";
 constexpr const char cfg_preserve_module_ports_key_name[] = "preserve_module_ports";
 constexpr const char cfg_prevent_renaming_key_name[] = "prevent_renaming";
 constexpr const char cfg_clock_port_names_key_name[] = "clock_port_names";
@@ -35,8 +37,13 @@ constexpr const char cfg_reset_port_names_key_name[] = "reset_port_names";
 constexpr const char cfg_expand_reset_key_name[] = "expand_reset";
 constexpr const char cfg_error_port_name_key_name[] = "error_port_name";
 constexpr const char cfg_auto_error_port_key_name[] = "auto_error_port";
+constexpr const char cfg_error_tree_fan_in_key_name[] = "error_tree_fan_in";
+constexpr const char cfg_error_register_levels_key_name[] = "error_register_levels";
 constexpr const char cfg_insert_voter_before_ff_key_name[] = "insert_voter_before_ff";
 constexpr const char cfg_insert_voter_after_ff_key_name[] = "insert_voter_after_ff";
+constexpr const char cfg_ff_voter_placement_key_name[] = "ff_voter_placement";
+constexpr const char cfg_timing_model_key_name[] = "timing_model";
+constexpr const char cfg_timing_liberty_file_key_name[] = "timing_liberty_file";
 constexpr const char cfg_ff_cells_key_name[] = "ff_cells";
 constexpr const char cfg_additional_ff_cells_key_name[] = "additional_ff_cells";
 constexpr const char cfg_excluded_ff_cells_key_name[] = "excluded_ff_cells";
@@ -47,11 +54,13 @@ constexpr const char cfg_insert_voter_before_modules_key_name[] = "insert_voter_
 constexpr const char cfg_insert_voter_after_modules_key_name[] = "insert_voter_after_modules";
 constexpr const char cfg_insert_voter_on_clock_nets_key_name[] = "insert_voter_on_clock_nets";
 constexpr const char cfg_insert_voter_on_reset_nets_key_name[] = "insert_voter_on_reset_nets";
+constexpr const char cfg_shared_worker_key_name[] = "shared_worker";
 
 constexpr const char cfg_group_assignment_attr_name[] = "\\tmrx_assign_to_group";
 constexpr const char cfg_tmr_mode_attr_name[] = "\\tmrx_tmr_mode";
 constexpr const char cfg_tmr_voter_attr_name[] = "\\tmrx_tmr_voter";
 constexpr const char cfg_tmr_voter_safe_mode_attr_name[] = "\\tmrx_tmr_voter_safe_mode";
+constexpr const char cfg_tmr_voter_word_level_attr_name[] = "\\tmrx_tmr_voter_word_level";
 constexpr const char cfg_tmr_mode_full_module_insert_voter_before_modules_attr_name[] =
     "\\tmrx_tmr_mode_full_module_insert_voter_before_modules";
 constexpr const char cfg_tmr_mode_full_module_insert_voter_after_modules_attr_name[] =
@@ -66,10 +75,15 @@ constexpr const char cfg_tmr_mode_full_module_insert_voter_on_clock_nets_attr_na
     "\\tmrx_tmr_mode_full_module_insert_voter_on_clock_nets";
 constexpr const char cfg_tmr_mode_full_module_insert_voter_on_reset_nets_attr_name[] =
     "\\tmrx_tmr_mode_full_module_insert_voter_on_reset_nets";
+constexpr const char cfg_tmr_mode_full_module_shared_worker_attr_name[] =
+    "\\tmrx_tmr_mode_full_module_shared_worker";
 constexpr const char cfg_tmr_preserve_module_ports_attr_name[] = "\\tmrx_tmr_preserve_module_ports";
 constexpr const char cfg_prevent_renaming_attr_name[] = "\\tmrx_prevent_renaming";
 constexpr const char cfg_insert_voter_before_ff_attr_name[] = "\\tmrx_insert_voter_before_ff";
 constexpr const char cfg_insert_voter_after_ff_attr_name[] = "\\tmrx_insert_voter_after_ff";
+constexpr const char cfg_ff_voter_placement_attr_name[] = "\\tmrx_ff_voter_placement";
+constexpr const char cfg_timing_model_attr_name[] = "\\tmrx_timing_model";
+constexpr const char cfg_timing_liberty_file_attr_name[] = "\\tmrx_timing_liberty_file";
 constexpr const char cfg_clock_port_name_attr_name[] = "\\tmrx_clock_port_name";
 constexpr const char cfg_rst_port_name_attr_name[] = "\\tmrx_rst_port_name";
 constexpr const char cfg_expand_clock_attr_name[] = "\\tmrx_expand_clock";
@@ -79,12 +93,19 @@ constexpr const char cfg_logic_path_2_suffix_attr_name[] = "\\tmrx_logic_path_2_
 constexpr const char cfg_logic_path_3_suffix_attr_name[] = "\\tmrx_logic_path_3_suffix";
 constexpr const char cfg_error_port_name_attr_name[] = "\\tmrx_error_port_name";
 constexpr const char cfg_auto_error_port_attr_name[] = "\\tmrx_auto_error_port";
+constexpr const char cfg_error_tree_fan_in_attr_name[] = "\\tmrx_error_tree_fan_in";
+constexpr const char cfg_error_register_levels_attr_name[] = "\\tmrx_error_register_levels";
 
 constexpr const char cfg_tmr_mode_none_name[] = "None";
 constexpr const char cfg_tmr_mode_full_module_tmr_name[] = "FullModuleTMR";
 constexpr const char cfg_tmr_mode_logic_tmr_name[] = "LogicTMR";
 constexpr const char cfg_tmr_voter_default_name[] = "Default";
 constexpr const char cfg_tmr_voter_custom_name[] = "Custom";
+constexpr const char cfg_ff_voter_placement_all_name[] = "All";
+constexpr const char cfg_ff_voter_placement_feedback_cut_name[] = "FeedbackCut";
+constexpr const char cfg_timing_model_none_name[] = "None";
+constexpr const char cfg_timing_model_logic_depth_name[] = "LogicDepth";
+constexpr const char cfg_timing_model_liberty_name[] = "Liberty";
 constexpr const char cfg_unknown_name[] = "Unknown";
 
 constexpr const char cfg_true_value[] = "1";
@@ -107,7 +128,20 @@ constexpr const char tmrx_signal_name_const[] = "const";
 constexpr const char tmrx_signal_name_separator[] = "_";
 constexpr const char tmrx_voter_module_prefix[] = "\\tmrx_voter_";
 constexpr const char tmrx_voter_width_separator[] = "_w";
+constexpr const char tmrx_voter_default_kind[] = "default";
+constexpr const char tmrx_voter_custom_kind_prefix[] = "custom_";
 constexpr const char tmrx_auto_error_port_name[] = "\\tmrx_err_o";
+constexpr char tmrx_ff_source_separator = ';';
+// Bump when the format of tmrx -config-cache files changes.
+constexpr int tmrx_config_cache_version = 2;
+constexpr const char tmrx_config_cache_magic[] = "tmrx-config-cache";
+constexpr const char tmrx_config_cache_suffix[] = ".tmrxcfg";
+// Bump when the format of tmrx -incremental files or the expansion changes.
+constexpr int tmrx_module_cache_version = 1;
+constexpr const char tmrx_module_cache_magic[] = "tmrx-module-cache";
+constexpr const char tmrx_module_cache_suffix[] = ".il";
+// Logic depth of the default voter (AND, then two ORs) under the unit-delay model.
+constexpr double tmrx_voter_logic_depth = 3.0;
 
 constexpr const char tmrx_voter_port_a_name[] = "a";
 constexpr const char tmrx_voter_port_b_name[] = "b";
@@ -121,6 +155,9 @@ constexpr const char tmrx_voter_port_c_id[] = "\\c";
 constexpr const char tmrx_voter_port_y_id[] = "\\y";
 constexpr const char tmrx_voter_port_err_id[] = "\\err";
 
+constexpr const char tmrx_voter_width_param_name[] = "WIDTH";
+constexpr const char tmrx_voter_width_param_id[] = "\\WIDTH";
+
 static const char *const tmrx_voter_input_labels[tmrx_replication_factor] = {
     tmrx_voter_port_a_name,
     tmrx_voter_port_b_name,
@@ -138,6 +175,10 @@ const auto ATTRIBUTE_IMPL_MODULE = ID(tmrx_impl_module);
 const auto ATTRIBUTE_CLK_PORT = ID(tmrx_clk_port);
 const auto ATTRIBUTE_RST_PORT = ID(tmrx_rst_port);
 const auto ATTRIBUTE_ERROR_SINK = ID(tmrx_error_sink);
+const auto ATTRIBUTE_ERROR_LATENCY = ID(tmrx_error_latency);
+const auto ATTRIBUTE_VOTER_SITE = ID(tmrx_voter_site);
+const auto ATTRIBUTE_FF = ID(tmrx_ff);
+const auto ATTRIBUTE_FF_SOURCES = ID(tmrx_ff_sources);
 
 } // namespace TMRX
 YOSYS_NAMESPACE_END
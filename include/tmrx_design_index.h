@@ -0,0 +1,61 @@
+#ifndef TMRX_DESIGN_INDEX_H
+#define TMRX_DESIGN_INDEX_H
+
+#include "kernel/yosys.h"
+#include <cstddef>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+struct PortInfo {
+    bool input = false;
+    bool output = false;
+    int width = 0;
+};
+
+// Ports of one design module in port_id order, as seen by its instances.
+struct ModulePorts {
+    std::vector<RTLIL::IdString> order;
+    dict<RTLIL::IdString, PortInfo> info;
+};
+
+// Design-wide indices shared by one tmrx run.
+//
+// Instances: a reverse index from module type to the number of cells
+// instantiating it. TMRX keeps it current whenever it adds, retypes or
+// removes instances, so asking whether a module is still referenced never
+// rescans the design. Only instances of design modules are tracked; internal
+// cell types ($and, $dff, ...) are ignored.
+//
+// Ports: the port directions and widths of every design module, collected on
+// first lookup with a single fixup_ports(). Entries stay valid until TMRX
+// edits that module's interface and calls invalidatePorts().
+struct DesignIndex {
+    explicit DesignIndex(RTLIL::Design *design);
+
+    void addCell(const RTLIL::Cell *cell);
+    void retypeCell(RTLIL::Cell *cell, RTLIL::IdString type);
+    void addModule(const RTLIL::Module *module);
+    void removeModule(RTLIL::Module *module);
+
+    size_t instanceCount(RTLIL::IdString type) const;
+
+    const ModulePorts *modulePorts(RTLIL::IdString type);
+    const PortInfo *portInfo(RTLIL::IdString type, RTLIL::IdString port);
+    bool isPortInput(const RTLIL::Cell *cell, RTLIL::IdString port);
+    bool isPortOutput(const RTLIL::Cell *cell, RTLIL::IdString port);
+    void invalidatePorts(RTLIL::IdString type);
+
+  private:
+    void release(RTLIL::IdString type);
+
+    RTLIL::Design *design;
+    dict<RTLIL::IdString, size_t> instances;
+    dict<RTLIL::IdString, ModulePorts> ports;
+};
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
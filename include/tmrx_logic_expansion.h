@@ -2,6 +2,7 @@
 #define TMRX_LOGIC_EXPANSION_H
 
 #include "config_manager.h"
+#include "tmrx_design_index.h"
 #include "kernel/yosys.h"
 
 YOSYS_NAMESPACE_BEGIN
@@ -43,7 +44,7 @@ struct ResolvedSubmodule {
 
 } // namespace detail
 
-void logicTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr,
+void logicTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, DesignIndex *index,
                        const Config *cfgOverride = nullptr);
 
 } // namespace TMRX
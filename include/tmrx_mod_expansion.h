@@ -2,12 +2,14 @@
 #define TMRX_MOD_EXPANSION_H
 
 #include "config_manager.h"
+#include "tmrx_design_index.h"
 #include "kernel/yosys.h"
 
 YOSYS_NAMESPACE_BEGIN
 namespace TMRX {
 
-void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, const Config *cfg);
+void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, DesignIndex *index,
+                            const Config *cfg);
 
 }
 YOSYS_NAMESPACE_END
@@ -0,0 +1,68 @@
+#ifndef TMRX_MODULE_CACHE_H
+#define TMRX_MODULE_CACHE_H
+
+#include "config_manager.h"
+#include "tmrx_design_index.h"
+#include "kernel/yosys.h"
+#include <string>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+// Content-addressed cache of expanded modules for `tmrx -incremental`.
+//
+// The key of a module is the SHA-1 of the plugin build, its RTLIL before
+// expansion, its resolved config, the custom voter template and liberty file
+// that config uses, and the key of every module it instantiates (the content
+// of modules TMRX does not expand).
+// Children are expanded first, so a parent's key covers the whole subtree
+// below it.
+//
+// An entry is one RTLIL file holding the expanded module together with every
+// module TMRX created while expanding it (_tmrx_impl clone, wrapper, workers,
+// uniquified _a/_b/_c copies, voters) and every TMRX-created module these
+// instantiate. Restoring an entry replaces the module and adds the others
+// unless an equal expansion already created them in this run.
+struct ModuleCache {
+    ModuleCache(RTLIL::Design *design, const std::string &dir);
+
+    // Compute and remember the key of `module`. Must be called before the
+    // module is expanded and after all of its children were.
+    std::string moduleKey(RTLIL::Module *module, const Config *cfg);
+
+    // Restore the expansion of `name` stored under `key`. Returns false on a
+    // miss, leaving the design untouched.
+    bool restore(RTLIL::IdString name, const std::string &key, DesignIndex &index);
+
+    // Apply the entry stored under `key` like restore() does, without
+    // counting or logging it, and set `added` to the number of modules it
+    // added. `tmrx -j` merges the expansions of its worker processes this way.
+    bool apply(RTLIL::IdString name, const std::string &key, DesignIndex &index, size_t &added);
+
+    // Snapshot the design's modules before expanding a module on a miss, and
+    // store the expansion afterwards.
+    void beginExpansion();
+    void store(RTLIL::IdString name, const std::string &key);
+
+    size_t hits = 0;
+    size_t misses = 0;
+
+  private:
+    std::string entryPath(const std::string &key) const;
+    std::string contentKey(RTLIL::IdString name);
+
+    RTLIL::Design *design;
+    std::string dir;
+
+    // Modules present when the pass started; all others were created by TMRX.
+    pool<RTLIL::IdString> initialModules;
+    pool<RTLIL::IdString> modulesBeforeExpansion;
+
+    dict<RTLIL::IdString, std::string> keys;
+    dict<std::string, std::string> fileHashes;
+};
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
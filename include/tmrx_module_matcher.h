@@ -0,0 +1,70 @@
+#ifndef TMRX_MODULE_MATCHER_H
+#define TMRX_MODULE_MATCHER_H
+
+#include "kernel/yosys.h"
+#include <bitset>
+#include <map>
+#include <string>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+enum class PatternSyntax { Glob, Regex };
+
+// True if a [module] scope name is a glob pattern rather than a module name.
+bool isGlobPattern(const std::string &name);
+
+// Matches module names against a set of glob and regular expression patterns.
+//
+// Globs support `*`, `?` and `[...]` / `[!...]` classes and must match the
+// whole name. Regular expressions support literals, `.`, classes, `\d` `\w`
+// `\s`, grouping, `|` and the `*` `+` `?` repetitions. They match anywhere in
+// the name unless anchored with a leading `^` or a trailing `$`.
+//
+// All patterns are compiled into one Thompson NFA. Matching walks a DFA that
+// is built lazily from it and cached, so a name is classified against every
+// pattern in a single pass over its characters.
+struct ModuleMatcher {
+    // Compile `pattern` and return its index. Invalid patterns are errors.
+    int addPattern(const std::string &pattern, PatternSyntax syntax);
+
+    // Indices of the patterns matching `name`, in ascending order.
+    std::vector<int> match(const std::string &name) const;
+
+    size_t size() const { return patternCount; }
+
+  private:
+    struct NfaState {
+        enum class Kind { Byte, Split, Match };
+        Kind kind;
+        std::bitset<256> bytes; // Byte: accepted characters
+        int out = -1;
+        int out1 = -1;    // Split: second epsilon edge
+        int pattern = -1; // Match: pattern index
+    };
+
+    struct DfaState {
+        std::vector<int> nfaStates;
+        std::vector<int> matches;
+        std::vector<int> next; // per byte; -1 = not built yet
+    };
+
+    friend struct PatternCompiler;
+
+    int addState(NfaState state);
+    int dfaState(std::vector<int> nfaStates) const;
+    int step(int state, unsigned char byte) const;
+
+    std::vector<NfaState> nfa;
+    std::vector<int> starts;
+    size_t patternCount = 0;
+
+    mutable std::vector<DfaState> dfa;
+    mutable std::map<std::vector<int>, int> dfaIds;
+};
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef TMRX_STATS_H
+#define TMRX_STATS_H
+
+#include "kernel/yosys.h"
+#include "tmrx_trace.h"
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+// Figures for one phase, one module or a whole run. Cell and wire counts are
+// the net growth of the design; peakRssKb is how far the process' peak
+// resident set grew while the span was open.
+struct SpanStats {
+    double seconds = 0;
+    long cells = 0;
+    long wires = 0;
+    long voters = 0;
+    long peakRssKb = 0;
+
+    void add(const SpanStats &other);
+};
+
+struct ModuleStats {
+    std::string name;
+    std::string mode;
+    SpanStats total;
+    std::vector<std::pair<std::string, SpanStats>> phases;
+};
+
+// Collects the `tmrx -stats` report. One recorder is active per tmrx run; the
+// StatsModule / StatsPhase scopes and countVoters() below report to it and do
+// nothing when no recorder is active, so expansion code is instrumented
+// unconditionally.
+struct StatsRecorder {
+    explicit StatsRecorder(RTLIL::Design *design);
+    ~StatsRecorder();
+
+    static StatsRecorder *active();
+
+    void writeJson(const std::string &path);
+
+  private:
+    friend struct StatsModule;
+    friend struct StatsPhase;
+    friend void countVoters(size_t count);
+
+    struct Sample {
+        std::chrono::steady_clock::time_point time;
+        long cells;
+        long wires;
+        long voters;
+        long peakRssKb;
+    };
+
+    Sample sample() const;
+    SpanStats since(const Sample &start) const;
+
+    RTLIL::Design *design;
+    Sample runStart;
+    long voters = 0;
+    std::vector<ModuleStats> modules;
+    ModuleStats *current = nullptr;
+};
+
+// Measures the expansion of one module.
+struct StatsModule {
+    StatsModule(RTLIL::IdString name, const std::string &mode);
+    ~StatsModule();
+
+  private:
+    StatsRecorder *recorder;
+    StatsRecorder::Sample start;
+};
+
+// Measures one phase of the module currently being expanded, from
+// construction until end() or destruction. A phase that is entered several
+// times accumulates into a single entry. The phase is also a -trace span.
+struct StatsPhase {
+    explicit StatsPhase(const char *name);
+    ~StatsPhase();
+
+    void end();
+
+  private:
+    StatsRecorder *recorder;
+    const char *name;
+    StatsRecorder::Sample start;
+    TraceSpan span;
+};
+
+void countVoters(size_t count);
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
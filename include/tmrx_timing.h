@@ -0,0 +1,77 @@
+#ifndef TMRX_TIMING_H
+#define TMRX_TIMING_H
+
+#include "config_manager.h"
+#include "tmrx_voter_placement.h"
+#include "kernel/yosys.h"
+#include <string>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+// Cell delays read from a liberty file. The delay of a cell is the largest
+// nominal value (first table entry) of the cell_rise / cell_fall tables and
+// intrinsic_rise / intrinsic_fall attributes over its timing arcs.
+// `nominalDelay` is the median over all cells; it stands in for cell types
+// the library does not describe and scales the voter delay.
+struct TimingLibrary {
+    dict<RTLIL::IdString, double> cellDelays;
+    double nominalDelay = 1.0;
+};
+
+TimingLibrary readTimingLibrary(const std::string &path);
+
+// Delay of a cell under the configured timing model. LogicDepth counts one
+// unit per combinational cell or submodule instance and treats flip-flop
+// clock-to-Q as free; Liberty uses the library delays instead.
+struct DelayModel {
+    DelayModel(TimingModel model, const TimingLibrary *library);
+
+    double cellDelay(const RTLIL::Cell *cell) const;
+    double clockToQ(const RTLIL::Cell *flipFlop) const;
+    double voterDelay() const;
+
+  private:
+    TimingModel model;
+    const TimingLibrary *library;
+};
+
+enum class VoterSide { Before, After };
+
+// Longest-path estimate over the original netlist of one module. Paths start
+// at input ports and flip-flop outputs and end at output ports and flip-flop
+// inputs; combinational loops are cut where the walk first meets them.
+struct TimingAnalysis {
+    TimingAnalysis(const CellGraph &graph, const std::vector<RTLIL::Cell *> &flipFlops,
+                   const DelayModel &delays);
+
+    // Longest path ending at the inputs of `flipFlop` / starting at its outputs.
+    double arrival(RTLIL::Cell *flipFlop) const;
+    double departure(RTLIL::Cell *flipFlop) const;
+
+    // The side whose voter lands on the shorter of the two paths above, and
+    // the length of that path once the voter is in place.
+    VoterSide preferredSide(RTLIL::Cell *flipFlop) const;
+    double votedPath(RTLIL::Cell *flipFlop) const;
+
+    // Worst path of the module with the given flip-flop voters inserted.
+    double worstPath(const dict<RTLIL::Cell *, VoterSide> &voters = {}) const;
+
+  private:
+    dict<RTLIL::Cell *, double> cellArrivals(const dict<RTLIL::Cell *, VoterSide> &voters) const;
+    double inputArrival(RTLIL::Cell *flipFlop, const dict<RTLIL::Cell *, double> &times) const;
+
+    const CellGraph &graph;
+    DelayModel delays;
+    pool<RTLIL::Cell *> flipFlops;
+    std::vector<RTLIL::Cell *> order; // combinational cells, drivers first
+    pool<RTLIL::Cell *> outputDrivers;
+    dict<RTLIL::Cell *, double> arrivals;
+    dict<RTLIL::Cell *, double> departures;
+};
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef TMRX_TRACE_H
+#define TMRX_TRACE_H
+
+#include "kernel/yosys.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+// Collects the `tmrx -trace` profile as Chrome trace events, which load into
+// Perfetto or chrome://tracing. One recorder is active per tmrx run; TraceSpan
+// reports to it and does nothing when no recorder is active. Spans are
+// complete events on a single thread, so the viewer nests them by time.
+struct TraceRecorder {
+    TraceRecorder();
+    ~TraceRecorder();
+
+    static TraceRecorder *active();
+
+    void writeJson(const std::string &path) const;
+
+  private:
+    friend struct TraceSpan;
+
+    struct Event {
+        std::string name;
+        const char *category;
+        std::string detail;
+        long long beginUs;
+        long long durationUs;
+    };
+
+    long long now() const;
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<Event> events;
+};
+
+// One named span, from construction until end() or destruction. `detail` is
+// shown as the span's argument in the viewer.
+struct TraceSpan {
+    TraceSpan(const char *category, const std::string &name, const std::string &detail = "");
+    ~TraceSpan();
+
+    void end();
+
+  private:
+    TraceRecorder *recorder;
+    const char *category;
+    std::string name;
+    std::string detail;
+    long long beginUs = 0;
+};
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
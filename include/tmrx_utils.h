@@ -1,31 +1,84 @@
 #ifndef TMRX_UTILS_H
 #define TMRX_UTILS_H
 #include "config_manager.h"
+#include "tmrx_design_index.h"
+#include "kernel/sigtools.h"
 #include "kernel/yosys.h"
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 YOSYS_NAMESPACE_BEGIN
 namespace TMRX {
 
 bool isProperSubmodule(RTLIL::Module *mod);
-bool isFlipFlop(const RTLIL::Cell *cell, const RTLIL::Module *module, const Config *cfg);
+bool isFlipFlop(const RTLIL::Cell *cell, const Config *cfg);
+void resolveMarkedFlipFlops(RTLIL::Design *design);
 bool isClkWire(const RTLIL::Wire *w, const Config *cfg);
 bool isClkWire(RTLIL::IdString port, const Config *cfg);
 bool isRstWire(RTLIL::IdString port, const Config *cfg);
 bool isRstWire(const RTLIL::Wire *w, const Config *cfg);
 bool isTmrErrorOutWire(RTLIL::Wire *w, const Config *cfg);
 
+// Netlist index of one module, shared by every voter inserted during its
+// expansion. It is built once and then kept up to date through connect(),
+// addDrivers() and addCellDrivers() as TMRX adds cells and connections, so
+// inserting a voter never rescans the module. Voter instances are also
+// recorded in the design-wide `index`, which answers port directions.
+//
+// `voterCache` holds every voter inserted so far, keyed by its sigmapped
+// inputs and variant (voter kind with domain, word level), so insertVoter
+// votes each input triple once and reuses its output and error wires.
+struct AnalysisContext {
+    using VoterKey =
+        std::tuple<RTLIL::SigSpec, RTLIL::SigSpec, RTLIL::SigSpec, std::string, bool>;
+
+    AnalysisContext(RTLIL::Module *module, DesignIndex *index);
+
+    RTLIL::Module *module;
+    DesignIndex *index;
+    SigMap sigmap;
+    dict<VoterKey, std::pair<RTLIL::Wire *, RTLIL::Wire *>> voterCache;
+    size_t reusedVoters = 0;
+
+    void connect(const RTLIL::SigSpec &lhs, const RTLIL::SigSpec &rhs);
+    void addDrivers(const RTLIL::SigSpec &sig);
+    void addCellDrivers(const RTLIL::Cell *cell);
+    bool isDriven(const RTLIL::SigBit &bit) const;
+    bool isPortOutput(const RTLIL::Cell *cell, RTLIL::IdString port);
+
+  private:
+    pool<RTLIL::SigBit> drivenBits;
+};
+
 std::pair<std::vector<RTLIL::IdString>, std::vector<RTLIL::IdString>>
-getPortNames(const RTLIL::Cell *cell, const RTLIL::Design *design);
+getPortNames(const RTLIL::Cell *cell, DesignIndex *index);
+// NEW_ID numbering of one hierarchy level. Every module expansion of the level
+// starts drawing from the number the level started at, so the names TMRX
+// creates in a module do not depend on which modules of its level were
+// expanded before it, or in which process. Names only have to be unique
+// within their module. endModuleIds() records the last number an expansion
+// drew; endLevelIds() continues autoidx after the highest one.
+void beginLevelIds();
+void beginModuleIds();
+void endModuleIds(int lastId);
+int endLevelIds();
+
 RTLIL::IdString createVoterCell(RTLIL::Design *design, size_t wire_width,
                                 const std::string &name_prefix);
 std::pair<RTLIL::Wire *, RTLIL::Wire *>
-insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, const Config *cfg,
+insertVoter(AnalysisContext &ctx, const std::vector<RTLIL::SigSpec> &inputs, const Config *cfg,
             const std::string &domainSuffix = "");
 
 void connectErrorSignal(RTLIL::Module *mod, const std::vector<RTLIL::Wire *> &error_signals,
                         const Config *cfg);
 
+// Cycles between a voter disagreement and the error flag on `wire`, as
+// recorded on error ports whose aggregation is registered.
+int errorLatency(const RTLIL::Wire *wire);
+void setErrorLatency(RTLIL::Wire *wire, int latency);
+
 } // namespace TMRX
 YOSYS_NAMESPACE_END
 
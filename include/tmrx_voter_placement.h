@@ -0,0 +1,57 @@
+#ifndef TMRX_VOTER_PLACEMENT_H
+#define TMRX_VOTER_PLACEMENT_H
+
+#include "tmrx_design_index.h"
+#include "kernel/sigtools.h"
+#include "kernel/yosys.h"
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+// Cell-level connectivity of `cells`: the driving cell of every signal bit
+// and, for each cell, the cells driving its inputs (without duplicates).
+// Bits no cell drives, such as module inputs, record the cells reading them.
+// Built once per module on the original netlist and shared by the feedback
+// cut and the timing estimate.
+struct CellGraph {
+    CellGraph(RTLIL::Module *mod, const std::vector<RTLIL::Cell *> &cells, DesignIndex *index);
+
+    RTLIL::Module *module;
+    SigMap sigmap;
+    dict<RTLIL::SigBit, RTLIL::Cell *> drivers;
+    dict<RTLIL::Cell *, std::vector<RTLIL::Cell *>> fanIn;
+    dict<RTLIL::SigBit, std::vector<RTLIL::Cell *>> undrivenReaders;
+};
+
+// Select the flip-flops that need a voter so that every sequential feedback
+// loop of the graph's module passes through at least one of them.
+//
+// The register dependency graph has an edge from flip-flop u to flip-flop v
+// when u's output reaches one of v's inputs through combinational cells or
+// submodule instances (which are treated as combinational from every input to
+// every output). `flipFlops` are the candidate nodes. The result is a
+// feedback vertex set found with the usual greedy heuristic: flip-flops that
+// cannot lie on a loop (no remaining predecessors or successors) are peeled
+// off, self-loops go straight into the cut, and otherwise the flip-flop with
+// the largest in-degree * out-degree is cut next. Ties go to the flip-flop
+// with the lower `cost` (when given), then to the lower cell name, so the
+// result is stable between runs.
+pool<RTLIL::Cell *>
+selectFeedbackCutFlipFlops(const CellGraph &graph, const std::vector<RTLIL::Cell *> &flipFlops,
+                           const dict<RTLIL::Cell *, double> *cost = nullptr);
+
+// Select the flip-flops that a loop closing outside the module can pass
+// through: those reached from one of `inputs` through combinational cells
+// only, from which one of `outputs` is reachable. When the module's ports are
+// triplicated, the parent connects them without a voter, so such a loop is
+// only cut if these flip-flops are voted.
+pool<RTLIL::Cell *> selectBoundaryFlipFlops(const CellGraph &graph,
+                                            const std::vector<RTLIL::Cell *> &flipFlops,
+                                            const std::vector<RTLIL::Wire *> &inputs,
+                                            const std::vector<RTLIL::Wire *> &outputs);
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
+
+#endif
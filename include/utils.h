@@ -3,6 +3,8 @@
 
 #include "kernel/sigtools.h"
 #include "kernel/yosys.h"
+#include <algorithm>
+#include <vector>
 
 YOSYS_NAMESPACE_BEGIN
 namespace TMRX {
@@ -29,6 +31,31 @@ hashlib::dict<T, std::pair<Q, Q>> zipDicts(const hashlib::dict<T, Q> &a,
     return result;
 }
 
+// The IdStrings in `names` ordered by their string. IdString's own ordering
+// follows the interning index, which depends on what was created before.
+template <typename Names> std::vector<RTLIL::IdString> sortedNames(const Names &names) {
+    std::vector<RTLIL::IdString> sorted(names.begin(), names.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const RTLIL::IdString &a, const RTLIL::IdString &b) { return a.str() < b.str(); });
+    return sorted;
+}
+
+// Escape `text` for use inside a JSON string literal.
+std::string jsonEscape(const std::string &text);
+
+// Write `contents` to a temporary file next to `path` and rename it over
+// `path`, creating the directory if needed, so that concurrent runs sharing a
+// cache directory never read a partially written file.
+bool writeFileAtomically(const std::string &path, const std::string &contents);
+
+// SHA-1 of `data` as 40 hex digits, used to key cache files.
+std::string contentHash(const std::string &data);
+
+// Identifies the build of the plugin: the SHA-1 of the shared object it was
+// loaded from, or its compile time if that can't be read. Part of every cache
+// key, since a rebuilt plugin may expand or resolve differently.
+std::string pluginBuildId();
+
 } // namespace TMRX
 YOSYS_NAMESPACE_END
 
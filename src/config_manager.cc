@@ -3,10 +3,20 @@
 #include "kernel/rtlil.h"
 #include "kernel/yosys.h"
 #include "kernel/yosys_common.h"
+#include "tmrx_timing.h"
+#include "tmrx_trace.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 YOSYS_NAMESPACE_BEGIN
@@ -20,6 +30,7 @@ const std::set<std::string> &topLevelScopeNames() {
         cfg_group_scope_name,
         cfg_module_scope_name,
         cfg_specific_module_scope_name,
+        cfg_match_scope_name,
     };
     return keys;
 }
@@ -35,6 +46,7 @@ const std::set<std::string> &scopedConfigRootKeys() {
         cfg_tmr_voter_clock_net_key_name,
         cfg_tmr_voter_reset_net_key_name,
         cfg_tmr_voter_safe_mode_key_name,
+        cfg_tmr_voter_word_level_key_name,
         cfg_preserve_module_ports_key_name,
         cfg_prevent_renaming_key_name,
         cfg_clock_port_names_key_name,
@@ -43,6 +55,8 @@ const std::set<std::string> &scopedConfigRootKeys() {
         cfg_expand_reset_key_name,
         cfg_error_port_name_key_name,
         cfg_auto_error_port_key_name,
+        cfg_error_tree_fan_in_key_name,
+        cfg_error_register_levels_key_name,
         cfg_logic_scope_name,
         cfg_full_module_scope_name,
     };
@@ -60,6 +74,7 @@ const std::set<std::string> &scopedConfigRootKeysWithGroups() {
         cfg_tmr_voter_clock_net_key_name,
         cfg_tmr_voter_reset_net_key_name,
         cfg_tmr_voter_safe_mode_key_name,
+        cfg_tmr_voter_word_level_key_name,
         cfg_preserve_module_ports_key_name,
         cfg_prevent_renaming_key_name,
         cfg_clock_port_names_key_name,
@@ -68,6 +83,8 @@ const std::set<std::string> &scopedConfigRootKeysWithGroups() {
         cfg_expand_reset_key_name,
         cfg_error_port_name_key_name,
         cfg_auto_error_port_key_name,
+        cfg_error_tree_fan_in_key_name,
+        cfg_error_register_levels_key_name,
         cfg_logic_scope_name,
         cfg_full_module_scope_name,
         cfg_groups_key_name,
@@ -79,6 +96,9 @@ const std::set<std::string> &logicConfigKeys() {
     static const std::set<std::string> keys = {
         cfg_insert_voter_before_ff_key_name,
         cfg_insert_voter_after_ff_key_name,
+        cfg_ff_voter_placement_key_name,
+        cfg_timing_model_key_name,
+        cfg_timing_liberty_file_key_name,
         cfg_ff_cells_key_name,
         cfg_additional_ff_cells_key_name,
         cfg_excluded_ff_cells_key_name,
@@ -95,6 +115,7 @@ const std::set<std::string> &fullModuleConfigKeys() {
         cfg_insert_voter_after_modules_key_name,
         cfg_insert_voter_on_clock_nets_key_name,
         cfg_insert_voter_on_reset_nets_key_name,
+        cfg_shared_worker_key_name,
     };
     return keys;
 }
@@ -154,11 +175,14 @@ ConfigPart parseCommonConfigPart(const toml::value &t) {
     cfg.tmrVoter = parseTmrVoter(toml::find_or<std::string>(t, cfg_tmr_voter_key_name, ""));
 
     cfg.tmrVoterSafeMode = tomlFindOptional<bool>(t, cfg_tmr_voter_safe_mode_key_name);
+    cfg.tmrVoterWordLevel = tomlFindOptional<bool>(t, cfg_tmr_voter_word_level_key_name);
     cfg.preserveModulePorts = tomlFindOptional<bool>(t, cfg_preserve_module_ports_key_name);
     cfg.preventRenaming = tomlFindOptional<bool>(t, cfg_prevent_renaming_key_name);
     cfg.expandClock = tomlFindOptional<bool>(t, cfg_expand_clock_key_name);
     cfg.expandReset = tomlFindOptional<bool>(t, cfg_expand_reset_key_name);
     cfg.autoErrorPort = tomlFindOptional<bool>(t, cfg_auto_error_port_key_name);
+    cfg.errorTreeFanIn = tomlFindOptional<int>(t, cfg_error_tree_fan_in_key_name);
+    cfg.errorRegisterLevels = tomlFindOptional<int>(t, cfg_error_register_levels_key_name);
 
     cfg.tmrVoterFile = tomlFindOptional<std::string>(t, cfg_tmr_voter_file_key_name);
     cfg.tmrVoterModule = tomlFindOptional<std::string>(t, cfg_tmr_voter_module_key_name);
@@ -181,6 +205,11 @@ ConfigPart parseLogicConfigPart(const toml::value &t) {
 
     cfg.insertVoterBeforeFf = tomlFindOptional<bool>(t, cfg_insert_voter_before_ff_key_name);
     cfg.insertVoterAfterFf = tomlFindOptional<bool>(t, cfg_insert_voter_after_ff_key_name);
+    cfg.ffVoterPlacement =
+        parseFfVoterPlacement(toml::find_or<std::string>(t, cfg_ff_voter_placement_key_name, ""));
+    cfg.timingModel =
+        parseTimingModel(toml::find_or<std::string>(t, cfg_timing_model_key_name, ""));
+    cfg.timingLibertyFile = tomlFindOptional<std::string>(t, cfg_timing_liberty_file_key_name);
 
     cfg.logicPath1Suffix = tomlFindOptional<std::string>(t, cfg_logic_path_1_suffix_key_name);
     cfg.logicPath2Suffix = tomlFindOptional<std::string>(t, cfg_logic_path_2_suffix_key_name);
@@ -204,6 +233,7 @@ ConfigPart parseFullModuleConfigPart(const toml::value &t) {
         tomlFindOptional<bool>(t, cfg_insert_voter_on_clock_nets_key_name);
     cfg.tmrModeFullModuleInsertVoterOnResetNets =
         tomlFindOptional<bool>(t, cfg_insert_voter_on_reset_nets_key_name);
+    cfg.tmrModeFullModuleSharedWorker = tomlFindOptional<bool>(t, cfg_shared_worker_key_name);
 
     return cfg;
 }
@@ -224,10 +254,14 @@ void mergeConfigPart(ConfigPart &dest, const ConfigPart &src) {
     mergeOptionalField(dest.tmrVoterClockNet, src.tmrVoterClockNet);
     mergeOptionalField(dest.tmrVoterResetNet, src.tmrVoterResetNet);
     mergeOptionalField(dest.tmrVoterSafeMode, src.tmrVoterSafeMode);
+    mergeOptionalField(dest.tmrVoterWordLevel, src.tmrVoterWordLevel);
     mergeOptionalField(dest.preserveModulePorts, src.preserveModulePorts);
     mergeOptionalField(dest.preventRenaming, src.preventRenaming);
     mergeOptionalField(dest.insertVoterBeforeFf, src.insertVoterBeforeFf);
     mergeOptionalField(dest.insertVoterAfterFf, src.insertVoterAfterFf);
+    mergeOptionalField(dest.ffVoterPlacement, src.ffVoterPlacement);
+    mergeOptionalField(dest.timingModel, src.timingModel);
+    mergeOptionalField(dest.timingLibertyFile, src.timingLibertyFile);
     mergeOptionalField(dest.tmrModeFullModuleInsertVoterBeforeModules,
                        src.tmrModeFullModuleInsertVoterBeforeModules);
     mergeOptionalField(dest.tmrModeFullModuleInsertVoterAfterModules,
@@ -236,6 +270,7 @@ void mergeConfigPart(ConfigPart &dest, const ConfigPart &src) {
                        src.tmrModeFullModuleInsertVoterOnClockNets);
     mergeOptionalField(dest.tmrModeFullModuleInsertVoterOnResetNets,
                        src.tmrModeFullModuleInsertVoterOnResetNets);
+    mergeOptionalField(dest.tmrModeFullModuleSharedWorker, src.tmrModeFullModuleSharedWorker);
     mergeOptionalField(dest.clockPortNames, src.clockPortNames);
     mergeOptionalField(dest.expandClock, src.expandClock);
     mergeOptionalField(dest.resetPortNames, src.resetPortNames);
@@ -248,6 +283,8 @@ void mergeConfigPart(ConfigPart &dest, const ConfigPart &src) {
     mergeOptionalField(dest.logicPath3Suffix, src.logicPath3Suffix);
     mergeOptionalField(dest.errorPortName, src.errorPortName);
     mergeOptionalField(dest.autoErrorPort, src.autoErrorPort);
+    mergeOptionalField(dest.errorTreeFanIn, src.errorTreeFanIn);
+    mergeOptionalField(dest.errorRegisterLevels, src.errorRegisterLevels);
 }
 
 std::vector<std::string> parseGroups(const toml::value &t) {
@@ -274,8 +311,156 @@ std::string quotedScopeContext(const std::string &scopeName, const std::string &
     return scopeName + ".\"" + entryName + "\"";
 }
 
+// Visits every field of a Config in a fixed order. Both the interning key
+// and the config cache serialize through this list.
+template <typename C, typename Visitor> void visitConfigFields(C &c, Visitor &v) {
+    v(c.tmrMode);
+    v(c.tmrVoter);
+    v(c.tmrVoterFile);
+    v(c.tmrVoterModule);
+    v(c.tmrVoterClockPortName);
+    v(c.tmrVoterResetPortName);
+    v(c.tmrVoterClockNet);
+    v(c.tmrVoterResetNet);
+    v(c.tmrVoterSafeMode);
+    v(c.tmrVoterWordLevel);
+    v(c.preserveModulePorts);
+    v(c.preventRenaming);
+    v(c.insertVoterBeforeFf);
+    v(c.insertVoterAfterFf);
+    v(c.ffVoterPlacement);
+    v(c.timingModel);
+    v(c.timingLibertyFile);
+    v(c.tmrModeFullModuleInsertVoterBeforeModules);
+    v(c.tmrModeFullModuleInsertVoterAfterModules);
+    v(c.tmrModeFullModuleInsertVoterOnClockNets);
+    v(c.tmrModeFullModuleInsertVoterOnResetNets);
+    v(c.tmrModeFullModuleSharedWorker);
+    v(c.clockPortNames);
+    v(c.expandClock);
+    v(c.resetPortNames);
+    v(c.expandReset);
+    v(c.ffCells);
+    v(c.additionalFfCells);
+    v(c.excludedFfCells);
+    v(c.logicPath1Suffix);
+    v(c.logicPath2Suffix);
+    v(c.logicPath3Suffix);
+    v(c.errorPortName);
+    v(c.autoErrorPort);
+    v(c.errorTreeFanIn);
+    v(c.errorRegisterLevels);
+}
+
+// Serializes values so that two configs have the same key exactly when they
+// are equal. Strings are length-prefixed and pools sorted, so neither
+// separators in names nor pool iteration order can cause clashes.
+struct ConfigKeyWriter {
+    std::string key;
+
+    void add(long long value) {
+        key += std::to_string(value);
+        key += ';';
+    }
+
+    void add(const std::string &value) {
+        key += std::to_string(value.size());
+        key += ':';
+        key += value;
+    }
+
+    void add(const Yosys::pool<Yosys::RTLIL::IdString> &pool) {
+        std::vector<std::string> names;
+        for (const auto &item : pool) {
+            names.push_back(item.str());
+        }
+        std::sort(names.begin(), names.end());
+        add(static_cast<long long>(names.size()));
+        for (const auto &name : names) {
+            add(name);
+        }
+    }
+
+    // Enums, bools and ints.
+    template <typename T> void add(const T &value) { add(static_cast<long long>(value)); }
+
+    template <typename T> void operator()(const T &value) { add(value); }
+};
+
+// Reads values written by ConfigKeyWriter. Malformed input clears `ok`
+// instead of failing, so that a damaged cache file is simply ignored.
+struct ConfigKeyReader {
+    const std::string &data;
+    size_t pos = 0;
+    bool ok = true;
+
+    explicit ConfigKeyReader(const std::string &data) : data(data) {}
+
+    bool atEnd() const { return pos == data.size(); }
+
+    long long readNumber(char terminator) {
+        size_t end = data.find(terminator, pos);
+        if (!ok || end == std::string::npos || end == pos) {
+            ok = false;
+            return 0;
+        }
+        char *parsedEnd = nullptr;
+        long long value = std::strtoll(data.c_str() + pos, &parsedEnd, 10);
+        if (parsedEnd != data.c_str() + end) {
+            ok = false;
+        }
+        pos = end + 1;
+        return value;
+    }
+
+    void read(long long &value) { value = readNumber(';'); }
+
+    void read(std::string &value) {
+        long long size = readNumber(':');
+        if (!ok || size < 0 || static_cast<size_t>(size) > data.size() - pos) {
+            ok = false;
+            return;
+        }
+        value = data.substr(pos, size);
+        pos += size;
+    }
+
+    void read(Yosys::pool<Yosys::RTLIL::IdString> &pool) {
+        long long count = readNumber(';');
+        pool.clear();
+        for (long long i = 0; ok && i < count; i++) {
+            std::string name;
+            read(name);
+            if (ok) {
+                pool.insert(Yosys::RTLIL::IdString(name));
+            }
+        }
+    }
+
+    template <typename T> void read(T &value) {
+        long long number = 0;
+        read(number);
+        value = static_cast<T>(number);
+    }
+
+    template <typename T> void operator()(T &value) { read(value); }
+};
+
+// Counts the visited fields; part of the cache key so that a plugin build
+// with a different Config layout does not read old cache files.
+struct ConfigFieldCounter {
+    long long count = 0;
+    template <typename T> void operator()(const T &) { count++; }
+};
+
 } // namespace
 
+std::string configKey(const Config &c) {
+    ConfigKeyWriter w;
+    visitConfigFields(c, w);
+    return w.key;
+}
+
 // ============================================================================
 // String conversion helpers
 // ============================================================================
@@ -324,6 +509,50 @@ std::string tmrVoterToString(TmrVoter voter) {
     return cfg_unknown_name;
 }
 
+std::optional<FfVoterPlacement> parseFfVoterPlacement(const std::string &str) {
+    if (str.empty())
+        return std::nullopt;
+    if (str == cfg_ff_voter_placement_all_name)
+        return FfVoterPlacement::All;
+    if (str == cfg_ff_voter_placement_feedback_cut_name)
+        return FfVoterPlacement::FeedbackCut;
+    return std::nullopt;
+}
+
+std::string ffVoterPlacementToString(FfVoterPlacement placement) {
+    switch (placement) {
+    case FfVoterPlacement::All:
+        return cfg_ff_voter_placement_all_name;
+    case FfVoterPlacement::FeedbackCut:
+        return cfg_ff_voter_placement_feedback_cut_name;
+    }
+    return cfg_unknown_name;
+}
+
+std::optional<TimingModel> parseTimingModel(const std::string &str) {
+    if (str.empty())
+        return std::nullopt;
+    if (str == cfg_timing_model_none_name)
+        return TimingModel::None;
+    if (str == cfg_timing_model_logic_depth_name)
+        return TimingModel::LogicDepth;
+    if (str == cfg_timing_model_liberty_name)
+        return TimingModel::Liberty;
+    return std::nullopt;
+}
+
+std::string timingModelToString(TimingModel model) {
+    switch (model) {
+    case TimingModel::None:
+        return cfg_timing_model_none_name;
+    case TimingModel::LogicDepth:
+        return cfg_timing_model_logic_depth_name;
+    case TimingModel::Liberty:
+        return cfg_timing_model_liberty_name;
+    }
+    return cfg_unknown_name;
+}
+
 // ============================================================================
 // TOML parsing helpers
 // ============================================================================
@@ -338,6 +567,7 @@ std::optional<T> tomlFindOptional(const toml::value &t, const std::string &key)
 
 // Explicit template instantiations
 template std::optional<bool> tomlFindOptional<bool>(const toml::value &t, const std::string &key);
+template std::optional<int> tomlFindOptional<int>(const toml::value &t, const std::string &key);
 template std::optional<std::string> tomlFindOptional<std::string>(const toml::value &t,
                                                                   const std::string &key);
 
@@ -367,6 +597,10 @@ template <typename T> void applyIfPresent(T &dest, const std::optional<T> &src)
 // Explicit template instantiations for common types
 template void applyIfPresent<TmrMode>(TmrMode &dest, const std::optional<TmrMode> &src);
 template void applyIfPresent<TmrVoter>(TmrVoter &dest, const std::optional<TmrVoter> &src);
+template void applyIfPresent<FfVoterPlacement>(FfVoterPlacement &dest,
+                                               const std::optional<FfVoterPlacement> &src);
+template void applyIfPresent<TimingModel>(TimingModel &dest,
+                                          const std::optional<TimingModel> &src);
 template void applyIfPresent<bool>(bool &dest, const std::optional<bool> &src);
 template void applyIfPresent<std::string>(std::string &dest, const std::optional<std::string> &src);
 template void applyIfPresent<Yosys::pool<Yosys::RTLIL::IdString>>(
@@ -404,17 +638,22 @@ void ConfigManager::loadGlobalDefaultCfg() {
     globalCfg.tmrVoterClockNet = "";
     globalCfg.tmrVoterResetNet = "";
     globalCfg.tmrVoterSafeMode = true;
+    globalCfg.tmrVoterWordLevel = false;
 
     globalCfg.preserveModulePorts = false;
     globalCfg.preventRenaming = false;
 
     globalCfg.insertVoterBeforeFf = false;
     globalCfg.insertVoterAfterFf = true;
+    globalCfg.ffVoterPlacement = FfVoterPlacement::All;
+    globalCfg.timingModel = TimingModel::None;
+    globalCfg.timingLibertyFile = "";
 
     globalCfg.tmrModeFullModuleInsertVoterBeforeModules = false;
     globalCfg.tmrModeFullModuleInsertVoterAfterModules = true;
     globalCfg.tmrModeFullModuleInsertVoterOnClockNets = false;
     globalCfg.tmrModeFullModuleInsertVoterOnResetNets = false;
+    globalCfg.tmrModeFullModuleSharedWorker = false;
 
     globalCfg.clockPortNames = {Yosys::RTLIL::IdString(cfg_default_clock_port_name)};
     globalCfg.resetPortNames = {Yosys::RTLIL::IdString(cfg_default_reset_port_name)};
@@ -432,6 +671,8 @@ void ConfigManager::loadGlobalDefaultCfg() {
 
     globalCfg.errorPortName = "";
     globalCfg.autoErrorPort = false;
+    globalCfg.errorTreeFanIn = 2;
+    globalCfg.errorRegisterLevels = 0;
 }
 
 void ConfigManager::loadDefaultGroupsCfg() {
@@ -446,7 +687,8 @@ void ConfigManager::loadDefaultGroupsCfg() {
 }
 
 std::string ConfigManager::getStringAttrValueOr(const Yosys::RTLIL::Module *mod,
-                                                const std::string &attr, const std::string &def) {
+                                                const std::string &attr,
+                                                const std::string &def) const {
     std::string ret = def;
     if (mod->has_attribute(attr)) {
         ret = mod->get_string_attribute(attr);
@@ -454,7 +696,7 @@ std::string ConfigManager::getStringAttrValueOr(const Yosys::RTLIL::Module *mod,
     return ret;
 }
 bool ConfigManager::getBoolAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr,
-                                       bool def) {
+                                       bool def) const {
     bool ret = def;
     if (mod->has_attribute(attr)) {
         ret = (mod->get_string_attribute(attr)) == cfg_true_value;
@@ -462,7 +704,7 @@ bool ConfigManager::getBoolAttrValueOr(const Yosys::RTLIL::Module *mod, const st
     return ret;
 }
 int ConfigManager::getIntAttrValueOr(const Yosys::RTLIL::Module *mod, const std::string &attr,
-                                     int def) {
+                                     int def) const {
     int ret = def;
     if (mod->has_attribute(attr)) {
         ret = std::stoi(mod->get_string_attribute(attr));
@@ -471,29 +713,45 @@ int ConfigManager::getIntAttrValueOr(const Yosys::RTLIL::Module *mod, const std:
 }
 
 std::optional<std::string> ConfigManager::getStringAttrValue(const Yosys::RTLIL::Module *mod,
-                                                             const std::string &attr) {
+                                                             const std::string &attr) const {
     if (mod->has_attribute(attr)) {
         return mod->get_string_attribute(attr);
     }
     return std::nullopt;
 }
 std::optional<bool> ConfigManager::getBoolAttrValue(const Yosys::RTLIL::Module *mod,
-                                                    const std::string &attr) {
+                                                    const std::string &attr) const {
     if (mod->has_attribute(attr)) {
         return (mod->get_string_attribute(attr)) == cfg_true_value;
     }
     return std::nullopt;
 }
 std::optional<int> ConfigManager::getIntAttrValue(const Yosys::RTLIL::Module *mod,
-                                                  const std::string &attr) {
-    if (mod->has_attribute(attr)) {
-        return std::stoi(mod->get_string_attribute(attr));
+                                                  const std::string &attr) const {
+    if (!mod->has_attribute(attr)) {
+        return std::nullopt;
     }
-    return std::nullopt;
+
+    // `(* attr = 4 *)` is a plain integer constant, `(* attr = "4" *)` a string.
+    const Yosys::RTLIL::Const &value = mod->attributes.at(attr);
+    if ((value.flags & Yosys::RTLIL::CONST_FLAG_STRING) == 0) {
+        return value.as_int((value.flags & Yosys::RTLIL::CONST_FLAG_SIGNED) != 0);
+    }
+
+    std::string text = value.decode_string();
+    errno = 0;
+    char *end = nullptr;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+        Yosys::log_error("Module '%s': attribute '%s' must be an integer (got '%s').\n",
+                         Yosys::log_id(mod->name), Yosys::log_id(attr), text.c_str());
+    }
+    return static_cast<int>(parsed);
 }
 
 std::optional<std::vector<std::string>>
-ConfigManager::getStringListAttrValue(const Yosys::RTLIL::Module *mod, const std::string &attr) {
+ConfigManager::getStringListAttrValue(const Yosys::RTLIL::Module *mod,
+                                      const std::string &attr) const {
     if (mod->has_attribute(attr)) {
         std::vector<std::string> res;
         std::string attrList = mod->get_string_attribute(attr);
@@ -508,7 +766,7 @@ ConfigManager::getStringListAttrValue(const Yosys::RTLIL::Module *mod, const std
     return std::nullopt;
 }
 
-ConfigPart ConfigManager::parseConfig(const toml::value &t) {
+ConfigPart ConfigManager::parseConfig(const toml::value &t) const {
     ConfigPart cfg = parseCommonConfigPart(t);
 
     if (t.contains(cfg_logic_scope_name)) {
@@ -523,7 +781,8 @@ ConfigPart ConfigManager::parseConfig(const toml::value &t) {
 }
 
 std::optional<Yosys::pool<Yosys::RTLIL::IdString>>
-ConfigManager::parseAttrIdStringPool(const Yosys::RTLIL::Module *mod, const std::string &attr) {
+ConfigManager::parseAttrIdStringPool(const Yosys::RTLIL::Module *mod,
+                                     const std::string &attr) const {
     auto strs = getStringListAttrValue(mod, attr);
     if (!strs)
         return std::nullopt;
@@ -535,7 +794,7 @@ ConfigManager::parseAttrIdStringPool(const Yosys::RTLIL::Module *mod, const std:
     return pool;
 }
 
-ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod) {
+ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod) const {
     ConfigPart cfg;
 
     // Parse enum fields
@@ -544,10 +803,16 @@ ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod
 
     // Parse boolean fields
     cfg.tmrVoterSafeMode = getBoolAttrValue(mod, cfg_tmr_voter_safe_mode_attr_name);
+    cfg.tmrVoterWordLevel = getBoolAttrValue(mod, cfg_tmr_voter_word_level_attr_name);
     cfg.preserveModulePorts = getBoolAttrValue(mod, cfg_tmr_preserve_module_ports_attr_name);
     cfg.preventRenaming = getBoolAttrValue(mod, cfg_prevent_renaming_attr_name);
     cfg.insertVoterBeforeFf = getBoolAttrValue(mod, cfg_insert_voter_before_ff_attr_name);
     cfg.insertVoterAfterFf = getBoolAttrValue(mod, cfg_insert_voter_after_ff_attr_name);
+    cfg.ffVoterPlacement =
+        parseFfVoterPlacement(getStringAttrValueOr(mod, cfg_ff_voter_placement_attr_name, ""));
+    cfg.timingModel =
+        parseTimingModel(getStringAttrValueOr(mod, cfg_timing_model_attr_name, ""));
+    cfg.timingLibertyFile = getStringAttrValue(mod, cfg_timing_liberty_file_attr_name);
     cfg.tmrModeFullModuleInsertVoterBeforeModules =
         getBoolAttrValue(mod, cfg_tmr_mode_full_module_insert_voter_before_modules_attr_name);
     cfg.tmrModeFullModuleInsertVoterAfterModules =
@@ -556,6 +821,8 @@ ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod
         getBoolAttrValue(mod, cfg_tmr_mode_full_module_insert_voter_on_clock_nets_attr_name);
     cfg.tmrModeFullModuleInsertVoterOnResetNets =
         getBoolAttrValue(mod, cfg_tmr_mode_full_module_insert_voter_on_reset_nets_attr_name);
+    cfg.tmrModeFullModuleSharedWorker =
+        getBoolAttrValue(mod, cfg_tmr_mode_full_module_shared_worker_attr_name);
     cfg.expandClock = getBoolAttrValue(mod, cfg_expand_clock_attr_name);
     cfg.expandReset = getBoolAttrValue(mod, cfg_expand_rst_attr_name);
 
@@ -571,6 +838,8 @@ ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod
     cfg.logicPath3Suffix = getStringAttrValue(mod, cfg_logic_path_3_suffix_attr_name);
     cfg.errorPortName = getStringAttrValue(mod, cfg_error_port_name_attr_name);
     cfg.autoErrorPort = getBoolAttrValue(mod, cfg_auto_error_port_attr_name);
+    cfg.errorTreeFanIn = getIntAttrValue(mod, cfg_error_tree_fan_in_attr_name);
+    cfg.errorRegisterLevels = getIntAttrValue(mod, cfg_error_register_levels_attr_name);
 
     // Parse IdString pool fields
     cfg.clockPortNames = parseAttrIdStringPool(mod, cfg_clock_port_name_attr_name);
@@ -579,7 +848,7 @@ ConfigPart ConfigManager::parseModuleAnnotations(const Yosys::RTLIL::Module *mod
     return cfg;
 }
 
-Config ConfigManager::assembleConfig(std::vector<ConfigPart> parts, Config def) {
+Config ConfigManager::assembleConfig(std::vector<ConfigPart> parts, Config def) const {
     Config cfg(def);
     for (const auto &part : parts) {
         applyIfPresent(cfg.tmrMode, part.tmrMode);
@@ -591,10 +860,14 @@ Config ConfigManager::assembleConfig(std::vector<ConfigPart> parts, Config def)
         applyIfPresent(cfg.tmrVoterClockNet, part.tmrVoterClockNet);
         applyIfPresent(cfg.tmrVoterResetNet, part.tmrVoterResetNet);
         applyIfPresent(cfg.tmrVoterSafeMode, part.tmrVoterSafeMode);
+        applyIfPresent(cfg.tmrVoterWordLevel, part.tmrVoterWordLevel);
         applyIfPresent(cfg.preserveModulePorts, part.preserveModulePorts);
         applyIfPresent(cfg.preventRenaming, part.preventRenaming);
         applyIfPresent(cfg.insertVoterBeforeFf, part.insertVoterBeforeFf);
         applyIfPresent(cfg.insertVoterAfterFf, part.insertVoterAfterFf);
+        applyIfPresent(cfg.ffVoterPlacement, part.ffVoterPlacement);
+        applyIfPresent(cfg.timingModel, part.timingModel);
+        applyIfPresent(cfg.timingLibertyFile, part.timingLibertyFile);
         applyIfPresent(cfg.tmrModeFullModuleInsertVoterBeforeModules,
                        part.tmrModeFullModuleInsertVoterBeforeModules);
         applyIfPresent(cfg.tmrModeFullModuleInsertVoterAfterModules,
@@ -603,6 +876,7 @@ Config ConfigManager::assembleConfig(std::vector<ConfigPart> parts, Config def)
                        part.tmrModeFullModuleInsertVoterOnClockNets);
         applyIfPresent(cfg.tmrModeFullModuleInsertVoterOnResetNets,
                        part.tmrModeFullModuleInsertVoterOnResetNets);
+        applyIfPresent(cfg.tmrModeFullModuleSharedWorker, part.tmrModeFullModuleSharedWorker);
         applyIfPresent(cfg.clockPortNames, part.clockPortNames);
         applyIfPresent(cfg.expandClock, part.expandClock);
         applyIfPresent(cfg.resetPortNames, part.resetPortNames);
@@ -615,283 +889,428 @@ Config ConfigManager::assembleConfig(std::vector<ConfigPart> parts, Config def)
         applyIfPresent(cfg.logicPath3Suffix, part.logicPath3Suffix);
         applyIfPresent(cfg.errorPortName, part.errorPortName);
         applyIfPresent(cfg.autoErrorPort, part.autoErrorPort);
+        applyIfPresent(cfg.errorTreeFanIn, part.errorTreeFanIn);
+        applyIfPresent(cfg.errorRegisterLevels, part.errorRegisterLevels);
     }
     return cfg;
 }
 
-void ConfigManager::appendGroupConfigs(
-    std::vector<ConfigPart> &cfgParts,
-    const Yosys::dict<Yosys::RTLIL::IdString, std::vector<std::string>> &groupAssignments,
-    Yosys::RTLIL::IdString lookupName, Yosys::RTLIL::IdString logName) {
+// Groups a module joins through its own attributes: tmrx_assign_to_group and
+// the default black-box group. Computed once per module name.
+const std::vector<std::string> &
+ConfigManager::attributeGroups(Yosys::RTLIL::IdString modName) const {
+    auto known = attrGroupAssignments.find(modName);
+    if (known != attrGroupAssignments.end()) {
+        return known->second;
+    }
+
+    std::vector<std::string> &groups = attrGroupAssignments[modName];
+    Yosys::RTLIL::Module *module =
+        designModules.count(modName) != 0 ? design->module(modName) : nullptr;
+    if (module == nullptr) {
+        return groups;
+    }
+
+    auto groupNames = getStringListAttrValue(module, cfg_group_assignment_attr_name);
+    if (groupNames) {
+        groups = *groupNames;
+    }
+
+    if (module->has_memories() || module->has_processes()) {
+        groups.push_back(cfg_default_black_box_module_group_name);
+        Yosys::log_warning(
+            "Module %s contains memories or processes, module will be treated as black box",
+            modName.c_str());
+    }
+
+    if (module->get_blackbox_attribute()) {
+        groups.push_back(cfg_default_black_box_module_group_name);
+    }
+
+    return groups;
+}
 
-    if (groupAssignments.count(lookupName) == 0)
+void ConfigManager::appendGroupConfig(std::vector<ConfigPart> &cfgParts,
+                                      const std::string &groupName,
+                                      Yosys::RTLIL::IdString logName) const {
+    if (groupCfg.count(groupName) == 0) {
+        Yosys::log_warning("Group %s for module %s not found, skipping assignment",
+                           groupName.c_str(), logName.c_str());
         return;
+    }
+    cfgParts.push_back(groupCfg.at(groupName));
+}
 
-    for (const auto &groupName : groupAssignments.at(lookupName)) {
-        if (groupCfg.count(groupName) == 0) {
-            Yosys::log_warning("Group %s for module %s not found, skipping assignment",
-                               groupName.c_str(), logName.c_str());
-            continue;
+void ConfigManager::appendGroupConfigs(std::vector<ConfigPart> &cfgParts,
+                                       Yosys::RTLIL::IdString lookupName,
+                                       Yosys::RTLIL::IdString logName) const {
+    if (groupAssignments.count(lookupName) != 0) {
+        for (const auto &groupName : groupAssignments.at(lookupName)) {
+            appendGroupConfig(cfgParts, groupName, logName);
         }
-        cfgParts.push_back(groupCfg.at(groupName));
+    }
+    for (const auto &groupName : attributeGroups(lookupName)) {
+        appendGroupConfig(cfgParts, groupName, logName);
     }
 }
 
 void ConfigManager::appendConfigIfPresent(
     std::vector<ConfigPart> &cfgParts,
-    const Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> &cfgMap, Yosys::RTLIL::IdString key) {
+    const Yosys::dict<Yosys::RTLIL::IdString, ConfigPart> &cfgMap,
+    Yosys::RTLIL::IdString key) const {
 
     if (cfgMap.count(key) != 0) {
         cfgParts.push_back(cfgMap.at(key));
     }
 }
 
-void ConfigManager::loadCustomVoters(Yosys::RTLIL::Design *design) {
-    Yosys::pool<std::string> loaded_files;
+void ConfigManager::loadTimingLibrary(Yosys::RTLIL::IdString modName, const Config &c) {
+    if (c.tmrMode != TmrMode::LogicTMR || c.timingModel != TimingModel::Liberty)
+        return;
 
-    for (auto &[modName, c] : finalModuleCfgs) {
-        if (c.tmrVoter != TmrVoter::Custom)
-            continue;
+    if (c.timingLibertyFile.empty())
+        Yosys::log_error(
+            "Module '%s' uses the Liberty timing model but timing_liberty_file is not set.\n",
+            modName.c_str());
 
-        if (c.tmrVoterFile.empty())
-            Yosys::log_error("Module '%s' uses Custom voter but tmr_voter_file is not set.\n",
-                             modName.c_str());
-
-        if (c.tmrVoterModule.empty())
-            Yosys::log_error("Module '%s' uses Custom voter but tmr_voter_module is not set.\n",
-                             modName.c_str());
-
-        if (loaded_files.count(c.tmrVoterFile) == 0) {
-            Yosys::log("Loading custom voter cell from '%s'\n", c.tmrVoterFile.c_str());
-            Yosys::run_pass("read_verilog " + c.tmrVoterFile, design);
-            // Convert any remaining behavioral code (always blocks present in
-            // partially-synthesised netlists) to RTLIL cells so that the
-            // subsequent techmap / dfflibmap passes can process them.
-            Yosys::run_pass("proc", design);
-            Yosys::run_pass("opt -fast", design);
-            loaded_files.insert(c.tmrVoterFile);
-        }
+    if (timingLibraries.count(c.timingLibertyFile) == 0) {
+        TraceSpan span("config", "loadTimingLibrary", c.timingLibertyFile);
+        timingLibraries[c.timingLibertyFile] =
+            std::make_shared<const TimingLibrary>(readTimingLibrary(c.timingLibertyFile));
+    }
+}
 
-        // Validate the loaded module has the required 1-bit port interface.
-        Yosys::RTLIL::IdString voterId = makeRtlilId(c.tmrVoterModule);
-        Yosys::RTLIL::Module *voterMod = design->module(voterId);
-
-        if (voterMod == nullptr)
-            Yosys::log_error(
-                "Module '%s': custom voter module '%s' was not found in the design after "
-                "loading '%s'.\n",
-                modName.c_str(), c.tmrVoterModule.c_str(), c.tmrVoterFile.c_str());
-
-        voterMod->fixup_ports();
-
-        const std::string voterModuleName = c.tmrVoterModule;
-        auto checkPort = [&](const std::string &port, bool expectInput) {
-            Yosys::RTLIL::Wire *w = voterMod->wire(makeRtlilId(port));
-            if (w == nullptr)
-                Yosys::log_error("Custom voter '%s': required port '%s' is missing.\n",
-                                 voterModuleName.c_str(), port.c_str());
-            if (w->width != 1)
-                Yosys::log_error("Custom voter '%s': port '%s' must be 1-bit (found %d-bit).\n",
-                                 voterModuleName.c_str(), port.c_str(), w->width);
-            if (expectInput && !w->port_input)
-                Yosys::log_error("Custom voter '%s': port '%s' must be an input.\n",
-                                 voterModuleName.c_str(), port.c_str());
-            if (!expectInput && !w->port_output)
-                Yosys::log_error("Custom voter '%s': port '%s' must be an output.\n",
-                                 voterModuleName.c_str(), port.c_str());
-        };
-
-        checkPort(tmrx_voter_port_a_name, true);
-        checkPort(tmrx_voter_port_b_name, true);
-        checkPort(tmrx_voter_port_c_name, true);
-        checkPort(tmrx_voter_port_y_name, false);
-        checkPort(tmrx_voter_port_err_name, false);
-
-        // Validate explicitly configured clock/reset port names.
-        if (!c.tmrVoterClockPortName.empty())
-            checkPort(c.tmrVoterClockPortName, true);
-        if (!c.tmrVoterResetPortName.empty())
-            checkPort(c.tmrVoterResetPortName, true);
-
-        // Keep the template module under its original name — insertVoter will
-        // clone it with a unique \tmrx_voter_<prefix>_w1 name per insertion
-        // site.  Exempt the template itself from TMR so it is never expanded.
-        Config exempt = globalCfg;
-        exempt.tmrMode = TmrMode::None;
-        exempt.preserveModulePorts = true;
-        exempt.tmrModeFullModuleInsertVoterBeforeModules = false;
-        exempt.tmrModeFullModuleInsertVoterAfterModules = false;
-        finalModuleCfgs[voterId] = exempt;
-        Yosys::log("Custom voter template '%s' exempted from TMR expansion.\n",
-                   c.tmrVoterModule.c_str());
-    }
-}
-
-void ConfigManager::validateCfg(Yosys::RTLIL::Design *design) {
-    bool anyExpandClock = false;
-    bool anyExpandReset = false;
+const TimingLibrary *ConfigManager::getTimingLibrary(const std::string &path) const {
+    auto library = timingLibraries.find(path);
+    return library != timingLibraries.end() ? library->second.get() : nullptr;
+}
 
-    for (auto module : design->modules()) {
-        // Re-read after potential overrides from earlier iterations.
-        Config &c =
-            finalModuleCfgs.count(module->name) ? finalModuleCfgs.at(module->name) : globalCfg;
-        const char *mod = module->name.c_str();
-        bool isBlackbox =
-            module->get_blackbox_attribute() || module->has_memories() || module->has_processes();
-
-        // Check 1: blackbox modules may only use None or FullModuleTMR.
-        if (isBlackbox && c.tmrMode == TmrMode::LogicTMR) {
-            Yosys::log_warning("Module '%s' has the blackbox attribute but tmr_mode is LogicTMR. "
-                               "LogicTMR is not supported for black-box modules. "
-                               "Overriding tmr_mode to FullModuleTMR.\n",
-                               mod);
-            c.tmrMode = TmrMode::FullModuleTMR;
-        }
+void ConfigManager::loadCustomVoter(Yosys::RTLIL::IdString modName, const Config &c) {
+    if (c.tmrVoter != TmrVoter::Custom)
+        return;
 
-        // Check 2: tmr_mode None requires preserve_module_ports.
-        if (c.tmrMode == TmrMode::None && !c.preserveModulePorts) {
-            Yosys::log_warning("Module '%s' has tmr_mode None but preserve_module_ports is false. "
-                               "Ports must be preserved when TMR is disabled. "
-                               "Overriding preserve_module_ports to true.\n",
-                               mod);
-            c.preserveModulePorts = true;
-        }
+    TraceSpan span("config", "loadCustomVoter", c.tmrVoterModule);
+
+    if (c.tmrVoterFile.empty())
+        Yosys::log_error("Module '%s' uses Custom voter but tmr_voter_file is not set.\n",
+                         modName.c_str());
+
+    if (c.tmrVoterModule.empty())
+        Yosys::log_error("Module '%s' uses Custom voter but tmr_voter_module is not set.\n",
+                         modName.c_str());
+
+    if (loadedVoterFiles.count(c.tmrVoterFile) == 0) {
+        Yosys::log("Loading custom voter cell from '%s'\n", c.tmrVoterFile.c_str());
+        Yosys::run_pass("read_verilog " + c.tmrVoterFile, design);
+        // Convert any remaining behavioral code (always blocks present in
+        // partially-synthesised netlists) to RTLIL cells so that the
+        // subsequent techmap / dfflibmap passes can process them.
+        Yosys::run_pass("proc", design);
+        Yosys::run_pass("opt -fast", design);
+        loadedVoterFiles.insert(c.tmrVoterFile);
+    }
 
-        // Check 3: preserve_module_ports with expanded clock or reset can insert voters on those
-        // nets.
-        if (c.preserveModulePorts && (c.expandClock || c.expandReset)) {
-            if (c.expandClock) {
-                Yosys::log_warning(
-                    "Module '%s' has preserve_module_ports enabled together with expand_clock. "
-                    "This may cause voters to be inserted on the clock net.\n",
-                    mod);
-            }
-            if (c.expandReset) {
-                Yosys::log_warning(
-                    "Module '%s' has preserve_module_ports enabled together with expand_reset. "
-                    "This may cause voters to be inserted on the reset net.\n",
-                    mod);
-            }
-        }
+    // Validate the loaded module has the required 1-bit port interface.
+    Yosys::RTLIL::IdString voterId = makeRtlilId(c.tmrVoterModule);
+    Yosys::RTLIL::Module *voterMod = design->module(voterId);
+
+    if (voterMod == nullptr)
+        Yosys::log_error(
+            "Module '%s': custom voter module '%s' was not found in the design after "
+            "loading '%s'.\n",
+            modName.c_str(), c.tmrVoterModule.c_str(), c.tmrVoterFile.c_str());
+
+    voterMod->fixup_ports();
+
+    const std::string voterModuleName = c.tmrVoterModule;
+    auto checkPort = [&](const std::string &port, bool expectInput) {
+        Yosys::RTLIL::Wire *w = voterMod->wire(makeRtlilId(port));
+        if (w == nullptr)
+            Yosys::log_error("Custom voter '%s': required port '%s' is missing.\n",
+                             voterModuleName.c_str(), port.c_str());
+        if (w->width != 1)
+            Yosys::log_error("Custom voter '%s': port '%s' must be 1-bit (found %d-bit).\n",
+                             voterModuleName.c_str(), port.c_str(), w->width);
+        if (expectInput && !w->port_input)
+            Yosys::log_error("Custom voter '%s': port '%s' must be an input.\n",
+                             voterModuleName.c_str(), port.c_str());
+        if (!expectInput && !w->port_output)
+            Yosys::log_error("Custom voter '%s': port '%s' must be an output.\n",
+                             voterModuleName.c_str(), port.c_str());
+    };
 
-        // Check 4: preserve_module_ports with auto_error_port can still add a new shared
-        // error output to the preserved interface.
-        if (c.preserveModulePorts && c.autoErrorPort) {
-            Yosys::log_warning(
-                "Module '%s' has preserve_module_ports enabled together with auto_error_port. "
-                "If voter errors exist, TMRX will still auto-create a shared error output "
-                "port.\n",
-                mod);
-        }
+    checkPort(tmrx_voter_port_a_name, true);
+    checkPort(tmrx_voter_port_b_name, true);
+    checkPort(tmrx_voter_port_c_name, true);
+    checkPort(tmrx_voter_port_y_name, false);
+    checkPort(tmrx_voter_port_err_name, false);
+
+    // Validate explicitly configured clock/reset port names.
+    if (!c.tmrVoterClockPortName.empty())
+        checkPort(c.tmrVoterClockPortName, true);
+    if (!c.tmrVoterResetPortName.empty())
+        checkPort(c.tmrVoterResetPortName, true);
+
+    // Word-level voting needs a width-parametric template; the 1-bit
+    // default elaboration checked above stays the per-bit fallback.
+    if (c.tmrVoterWordLevel &&
+        voterMod->avail_parameters.count(tmrx_voter_width_param_id) == 0 &&
+        warnedWordLevelVoters.insert(voterModuleName).second)
+        Yosys::log_warning("Custom voter '%s' has no '%s' parameter; "
+                           "tmr_voter_word_level falls back to one voter per bit.\n",
+                           voterModuleName.c_str(), tmrx_voter_width_param_name);
+
+    if (!exemptedVoterTemplates.insert(voterId).second)
+        return;
 
-        // Check 5: insert_voter_before_ff is not implemented — catch early.
-        if (c.insertVoterBeforeFf) {
-            Yosys::log_error("Module '%s': insert_voter_before_ff is not yet implemented.\n", mod);
-        }
+    // Keep the template module under its original name — insertVoter will
+    // clone it once per width and TMR domain as \tmrx_voter_custom_<name>_w1.
+    // Exempt the template itself from TMR so it is never expanded.
+    Config exempt = globalCfg;
+    exempt.tmrMode = TmrMode::None;
+    exempt.preserveModulePorts = true;
+    exempt.tmrModeFullModuleInsertVoterBeforeModules = false;
+    exempt.tmrModeFullModuleInsertVoterAfterModules = false;
+    setModuleConfig(voterId, exempt);
+    Yosys::log("Custom voter template '%s' exempted from TMR expansion.\n",
+               c.tmrVoterModule.c_str());
+}
 
-        // Check 6: duplicate path suffixes cause wire name collisions.
-        if (c.logicPath1Suffix == c.logicPath2Suffix || c.logicPath1Suffix == c.logicPath3Suffix ||
-            c.logicPath2Suffix == c.logicPath3Suffix) {
-            Yosys::log_error("Module '%s': logic path suffixes must be unique "
-                             "(got '%s', '%s', '%s').\n",
-                             mod, c.logicPath1Suffix.c_str(), c.logicPath2Suffix.c_str(),
-                             c.logicPath3Suffix.c_str());
-        }
+void ConfigManager::cfgWarning(const std::string &message) const {
+    cfgWarnings.push_back(message);
+    Yosys::log_warning("%s", message.c_str());
+}
 
-        // Check 7: FullModuleTMR-only options are no-ops in LogicTMR / None mode.
-        if (c.tmrMode != TmrMode::FullModuleTMR) {
-            if (c.tmrModeFullModuleInsertVoterBeforeModules)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_before_modules has no effect "
-                    "outside of FullModuleTMR mode.\n",
-                    mod);
-            if (c.tmrModeFullModuleInsertVoterAfterModules)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_after_modules has no effect "
-                    "outside of FullModuleTMR mode.\n",
-                    mod);
-            if (c.tmrModeFullModuleInsertVoterOnClockNets)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_clock_nets has no effect "
-                    "outside of FullModuleTMR mode.\n",
-                    mod);
-            if (c.tmrModeFullModuleInsertVoterOnResetNets)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_reset_nets has no effect "
-                    "outside of FullModuleTMR mode.\n",
-                    mod);
-        }
+// Validate the resolved config of one module and return it. Overrides replace
+// the module's config with a changed copy; other modules sharing the same
+// interned config are not affected.
+const Config *ConfigManager::validateCfg(const Yosys::RTLIL::Module *module,
+                                         const Config *c) const {
+    const char *mod = module->name.c_str();
+    bool isBlackbox =
+        module->get_blackbox_attribute() || module->has_memories() || module->has_processes();
+
+    // Check 1: blackbox modules may only use None or FullModuleTMR.
+    if (isBlackbox && c->tmrMode == TmrMode::LogicTMR) {
+        cfgWarning(Yosys::stringf(
+            "Module '%s' has the blackbox attribute but tmr_mode is LogicTMR. "
+            "LogicTMR is not supported for black-box modules. "
+            "Overriding tmr_mode to FullModuleTMR.\n",
+            mod));
+        Config overridden = *c;
+        overridden.tmrMode = TmrMode::FullModuleTMR;
+        c = setModuleConfig(module->name, overridden);
+    }
 
-        // Check 8: LogicTMR-only options are no-ops in FullModuleTMR mode.
-        if (c.tmrMode == TmrMode::FullModuleTMR) {
-            if (c.insertVoterAfterFf)
-                Yosys::log_warning(
-                    "Module '%s': insert_voter_after_ff has no effect in FullModuleTMR mode.\n",
-                    mod);
-            if (!c.ffCells.empty() || !c.additionalFfCells.empty() || !c.excludedFfCells.empty())
-                Yosys::log_warning(
-                    "Module '%s': ff_cells / additional_ff_cells / excluded_ff_cells have no "
-                    "effect in FullModuleTMR mode.\n",
-                    mod);
-        }
+    // Check 2: tmr_mode None requires preserve_module_ports.
+    if (c->tmrMode == TmrMode::None && !c->preserveModulePorts) {
+        cfgWarning(Yosys::stringf(
+            "Module '%s' has tmr_mode None but preserve_module_ports is false. "
+            "Ports must be preserved when TMR is disabled. "
+            "Overriding preserve_module_ports to true.\n",
+            mod));
+        Config overridden = *c;
+        overridden.preserveModulePorts = true;
+        c = setModuleConfig(module->name, overridden);
+    }
 
-        // Check 9: voter_on_clock/reset_nets is a no-op when the net is not expanded.
-        if (c.tmrMode == TmrMode::FullModuleTMR) {
-            if (c.tmrModeFullModuleInsertVoterOnClockNets && !c.expandClock)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_clock_nets is true but "
-                    "expand_clock is false — the flag has no effect.\n",
-                    mod);
-            if (c.tmrModeFullModuleInsertVoterOnResetNets && !c.expandReset)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_reset_nets is true but "
-                    "expand_reset is false — the flag has no effect.\n",
-                    mod);
-
-            // Check 10: both flags set — voters WILL be placed on the clock/reset net.
-            if (c.tmrModeFullModuleInsertVoterOnClockNets && c.expandClock)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_clock_nets and "
-                    "expand_clock are both enabled. Voters will be inserted on the clock net.\n",
-                    mod);
-            if (c.tmrModeFullModuleInsertVoterOnResetNets && c.expandReset)
-                Yosys::log_warning(
-                    "Module '%s': full_module.insert_voter_on_reset_nets and "
-                    "expand_reset are both enabled. Voters will be inserted on the reset net.\n",
-                    mod);
+    // Check 3: preserve_module_ports with expanded clock or reset can insert voters on those
+    // nets.
+    if (c->preserveModulePorts && (c->expandClock || c->expandReset)) {
+        if (c->expandClock) {
+            cfgWarning(Yosys::stringf(
+                "Module '%s' has preserve_module_ports enabled together with expand_clock. "
+                "This may cause voters to be inserted on the clock net.\n",
+                mod));
         }
+        if (c->expandReset) {
+            cfgWarning(Yosys::stringf(
+                "Module '%s' has preserve_module_ports enabled together with expand_reset. "
+                "This may cause voters to be inserted on the reset net.\n",
+                mod));
+        }
+    }
+
+    // Check 4: preserve_module_ports with auto_error_port can still add a new shared
+    // error output to the preserved interface.
+    if (c->preserveModulePorts && c->autoErrorPort) {
+        cfgWarning(Yosys::stringf(
+            "Module '%s' has preserve_module_ports enabled together with auto_error_port. "
+            "If voter errors exist, TMRX will still auto-create a shared error output "
+            "port.\n",
+            mod));
+    }
+
+    // Check 5: duplicate path suffixes cause wire name collisions.
+    if (c->logicPath1Suffix == c->logicPath2Suffix || c->logicPath1Suffix == c->logicPath3Suffix ||
+        c->logicPath2Suffix == c->logicPath3Suffix) {
+        Yosys::log_error("Module '%s': logic path suffixes must be unique "
+                         "(got '%s', '%s', '%s').\n",
+                         mod, c->logicPath1Suffix.c_str(), c->logicPath2Suffix.c_str(),
+                         c->logicPath3Suffix.c_str());
+    }
+
+    // Check 6: FullModuleTMR-only options are no-ops in LogicTMR / None mode.
+    if (c->tmrMode != TmrMode::FullModuleTMR) {
+        if (c->tmrModeFullModuleInsertVoterBeforeModules)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_before_modules has no effect "
+                "outside of FullModuleTMR mode.\n",
+                mod));
+        if (c->tmrModeFullModuleInsertVoterAfterModules)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_after_modules has no effect "
+                "outside of FullModuleTMR mode.\n",
+                mod));
+        if (c->tmrModeFullModuleInsertVoterOnClockNets)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_clock_nets has no effect "
+                "outside of FullModuleTMR mode.\n",
+                mod));
+        if (c->tmrModeFullModuleInsertVoterOnResetNets)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_reset_nets has no effect "
+                "outside of FullModuleTMR mode.\n",
+                mod));
+        if (c->tmrModeFullModuleSharedWorker)
+            cfgWarning(Yosys::stringf("Module '%s': full_module.shared_worker has no effect "
+                                      "outside of FullModuleTMR mode.\n",
+                                      mod));
+    }
+
+    // Check 7: LogicTMR-only options are no-ops in FullModuleTMR mode.
+    if (c->tmrMode == TmrMode::FullModuleTMR) {
+        if (c->insertVoterBeforeFf)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': insert_voter_before_ff has no effect in FullModuleTMR mode.\n",
+                mod));
+        if (c->insertVoterAfterFf)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': insert_voter_after_ff has no effect in FullModuleTMR mode.\n",
+                mod));
+        if (!c->ffCells.empty() || !c->additionalFfCells.empty() || !c->excludedFfCells.empty())
+            cfgWarning(Yosys::stringf(
+                "Module '%s': ff_cells / additional_ff_cells / excluded_ff_cells have no "
+                "effect in FullModuleTMR mode.\n",
+                mod));
+    }
+
+    // Check 8: voter_on_clock/reset_nets is a no-op when the net is not expanded.
+    if (c->tmrMode == TmrMode::FullModuleTMR) {
+        if (c->tmrModeFullModuleInsertVoterOnClockNets && !c->expandClock)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_clock_nets is true but "
+                "expand_clock is false — the flag has no effect.\n",
+                mod));
+        if (c->tmrModeFullModuleInsertVoterOnResetNets && !c->expandReset)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_reset_nets is true but "
+                "expand_reset is false — the flag has no effect.\n",
+                mod));
+
+        // Check 9: both flags set — voters WILL be placed on the clock/reset net.
+        if (c->tmrModeFullModuleInsertVoterOnClockNets && c->expandClock)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_clock_nets and "
+                "expand_clock are both enabled. Voters will be inserted on the clock net.\n",
+                mod));
+        if (c->tmrModeFullModuleInsertVoterOnResetNets && c->expandReset)
+            cfgWarning(Yosys::stringf(
+                "Module '%s': full_module.insert_voter_on_reset_nets and "
+                "expand_reset are both enabled. Voters will be inserted on the reset net.\n",
+                mod));
+    }
+
+    // Check 10: the error aggregation tree needs at least two inputs per cell.
+    if (c->errorTreeFanIn < 0 || c->errorTreeFanIn == 1) {
+        Yosys::log_error("Module '%s': error_tree_fan_in must be 0 or at least 2 (got %d).\n",
+                         mod, c->errorTreeFanIn);
+    }
+
+    // Check 11: register stages are placed every N tree levels.
+    if (c->errorRegisterLevels < 0) {
+        Yosys::log_error("Module '%s': error_register_levels must not be negative (got %d).\n",
+                         mod, c->errorRegisterLevels);
+    }
+
+    // Check 12: the placement only selects which flip-flops get voters.
+    if (c->tmrMode == TmrMode::LogicTMR && !c->insertVoterBeforeFf && !c->insertVoterAfterFf &&
+        c->ffVoterPlacement != FfVoterPlacement::All) {
+        cfgWarning(Yosys::stringf("Module '%s': ff_voter_placement has no effect when neither "
+                                  "insert_voter_before_ff nor insert_voter_after_ff is enabled.\n",
+                                  mod));
+    }
 
-        if (c.expandClock)
-            anyExpandClock = true;
-        if (c.expandReset)
-            anyExpandReset = true;
+    // Check 13: a timing model only chooses where flip-flop voters go.
+    if (c->tmrMode == TmrMode::LogicTMR && !c->insertVoterBeforeFf && !c->insertVoterAfterFf &&
+        c->timingModel != TimingModel::None) {
+        cfgWarning(Yosys::stringf("Module '%s': timing_model has no effect when neither "
+                                  "insert_voter_before_ff nor insert_voter_after_ff is enabled.\n",
+                                  mod));
     }
 
     // Check 4: any expand_clock/reset in the design can place voters on those nets.
-    if (anyExpandClock) {
-        Yosys::log_warning("One or more modules have expand_clock enabled. "
-                           "This may cause voters to be placed on clock nets.\n");
+    if (c->expandClock && !warnedExpandClock) {
+        warnedExpandClock = true;
+        cfgWarning("One or more modules have expand_clock enabled. "
+                   "This may cause voters to be placed on clock nets.\n");
     }
-    if (anyExpandReset) {
-        Yosys::log_warning("One or more modules have expand_reset enabled. "
-                           "This may cause voters to be placed on reset nets.\n");
+    if (c->expandReset && !warnedExpandReset) {
+        warnedExpandReset = true;
+        cfgWarning("One or more modules have expand_reset enabled. "
+                   "This may cause voters to be placed on reset nets.\n");
     }
+
+    return c;
 }
 
-ConfigManager::ConfigManager(Yosys::RTLIL::Design *design, const std::string &cfgFile) {
+ConfigManager::ConfigManager(Yosys::RTLIL::Design *design, const std::string &cfgFile,
+                             const std::string &cacheDir)
+    : design(design) {
+    TraceSpan span("config", "ConfigManager", cfgFile);
     Yosys::log_header(design, "Loading TMRX configuration\n");
     loadGlobalDefaultCfg();
     loadDefaultGroupsCfg();
 
+    // Configs are resolved on first use; only remember which modules exist
+    // now so that modules added by the expansion fall back to the global config.
+    for (auto module : design->modules()) {
+        designModules.insert(module->name);
+    }
+
+    configFile = cfgFile;
+    if (!cacheDir.empty()) {
+        cacheKey = configCacheKey(cfgFile);
+        cachePath = cacheDir + "/" + cacheKey + tmrx_config_cache_suffix;
+        if (readConfigCache()) {
+            cacheHit = true;
+            Yosys::log("Loaded %zu module configuration(s) from config cache '%s'\n",
+                       moduleCfgIds.size(), cachePath.c_str());
+            return;
+        }
+    }
+
+    loadConfigFile();
+}
+
+// Parse the TOML config file. Runs in the constructor unless the config cache
+// hit, and otherwise on the first module the cache does not cover.
+void ConfigManager::loadConfigFile() const {
+    if (configFileLoaded) {
+        return;
+    }
+    configFileLoaded = true;
+    TraceSpan span("config", "loadConfigFile", configFile);
+
     bool loadedCfg = true;
 
     toml::value t;
     try {
-        t = toml::parse(cfgFile);
+        t = toml::parse(configFile);
     } catch (const std::exception &e) {
         Yosys::log_warning("Tmrx was unable to load cfg file, will proceed with default config and "
                            "annotation '%s': %s. Using defaults.",
-                           cfgFile.c_str(), e.what());
+                           configFile.c_str(), e.what());
         loadedCfg = false;
     }
 
@@ -900,9 +1319,6 @@ ConfigManager::ConfigManager(Yosys::RTLIL::Design *design, const std::string &cf
             "Config file empty, tmrx will proceed with default config and annotation");
     }
 
-    ConfigPart globalConfigPart;
-    Yosys::dict<Yosys::RTLIL::IdString, std::vector<std::string>> groupAssignments;
-
     if (loadedCfg) {
         validateTopLevelScopes(t);
 
@@ -929,6 +1345,14 @@ ConfigManager::ConfigManager(Yosys::RTLIL::Design *design, const std::string &cf
             ensureTable(moduleRoot, cfg_module_scope_name);
 
             for (const auto &[moduleName, moduleValue] : moduleRoot.as_table()) {
+                if (isGlobPattern(moduleName)) {
+                    validateScopedConfigTable(
+                        moduleValue, quotedScopeContext(cfg_module_scope_name, moduleName), true);
+                    patternCfgs.push_back({moduleName, PatternSyntax::Glob,
+                                           parseConfig(moduleValue), parseGroups(moduleValue)});
+                    continue;
+                }
+
                 validateScopedConfigTable(moduleValue,
                                           scopeContext(cfg_module_scope_name, moduleName), true);
 
@@ -957,87 +1381,294 @@ ConfigManager::ConfigManager(Yosys::RTLIL::Design *design, const std::string &cf
                 specificModuleCfgs[moduleId] = parseConfig(moduleValue);
             }
         }
+
+        if (t.contains(cfg_match_scope_name)) {
+            const auto &matchRoot = t.at(cfg_match_scope_name);
+            ensureTable(matchRoot, cfg_match_scope_name);
+
+            for (const auto &[pattern, matchValue] : matchRoot.as_table()) {
+                validateScopedConfigTable(matchValue,
+                                          quotedScopeContext(cfg_match_scope_name, pattern), true);
+                patternCfgs.push_back({pattern, PatternSyntax::Regex, parseConfig(matchValue),
+                                       parseGroups(matchValue)});
+            }
+        }
     }
 
-    for (auto module : design->modules()) {
+    // Patterns with more literal characters are more specific: they are
+    // applied later and override broader ones. Ties go by pattern text.
+    auto literalCount = [](const std::string &pattern) {
+        return std::count_if(pattern.begin(), pattern.end(), [](char ch) {
+            return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+        });
+    };
+    std::sort(patternCfgs.begin(), patternCfgs.end(),
+              [&](const PatternScope &a, const PatternScope &b) {
+                  return std::make_tuple(literalCount(a.pattern), a.pattern, a.syntax) <
+                         std::make_tuple(literalCount(b.pattern), b.pattern, b.syntax);
+              });
+    for (const auto &scope : patternCfgs) {
+        moduleMatcher.addPattern(scope.pattern, scope.syntax);
+    }
+}
 
-        Yosys::RTLIL::IdString modName = module->name;
+const Config *ConfigManager::resolveConfig(Yosys::RTLIL::Module *mod) const {
+    // Proper submodules may be specific variants `<module>$<suffix>`: they
+    // also pick up the generic module's group and [module] configs.
+    Yosys::RTLIL::IdString specificModName = mod->name;
+    bool isSubmodule = mod->has_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE);
+    Yosys::RTLIL::IdString modName =
+        isSubmodule ? Yosys::RTLIL::IdString(specificModName.str().substr(
+                          0, specificModName.str().find(cfg_specific_module_separator)))
+                    : specificModName;
+
+    // Glob and regex scopes match the generic name. They come before the
+    // exact scopes, so [module.<name>] entries and annotations override them.
+    std::string matchName = modName.str();
+    if (!matchName.empty() && matchName[0] == '\\') {
+        matchName = matchName.substr(1);
+    }
+    std::vector<int> patterns = moduleMatcher.match(matchName);
 
-        auto groupNames = getStringListAttrValue(module, cfg_group_assignment_attr_name);
+    std::vector<ConfigPart> cfgParts = {globalConfigPart};
 
-        if (groupNames) {
-            for (const auto &name : *groupNames) {
-                groupAssignments[modName].push_back(name);
-            }
+    // Add group configs for matching patterns, then for both generic and
+    // specific module names
+    for (int pattern : patterns) {
+        for (const auto &groupName : patternCfgs.at(pattern).groups) {
+            appendGroupConfig(cfgParts, groupName, specificModName);
         }
+    }
+    appendGroupConfigs(cfgParts, modName, specificModName);
+    if (modName != specificModName) {
+        appendGroupConfigs(cfgParts, specificModName, specificModName);
+    }
+
+    // Add pattern and module-specific configs in precedence order
+    for (int pattern : patterns) {
+        cfgParts.push_back(patternCfgs.at(pattern).cfg);
+    }
+    appendConfigIfPresent(cfgParts, moduleCfgs, modName);
+    cfgParts.push_back(parseModuleAnnotations(mod));
+    if (isSubmodule) {
+        appendConfigIfPresent(cfgParts, specificModuleCfgs, specificModName);
+    }
+
+    return validateCfg(mod, setModuleConfig(mod->name, assembleConfig(cfgParts, globalCfg)));
+}
 
-        if (module->has_memories() || module->has_processes()) {
+void ConfigManager::resolveConfigs(const std::vector<Yosys::RTLIL::Module *> &modules) {
+    TraceSpan span("config", "resolveConfigs");
+    Yosys::pool<ConfigId> loaded;
 
-            groupAssignments[modName].push_back(cfg_default_black_box_module_group_name);
-            Yosys::log_warning(
-                "Module %s contains memories or processes, module will be treated as black box",
-                modName.c_str());
+    for (auto module : modules) {
+        const Config *c = getConfig(module);
+        if (!loaded.insert(moduleCfgIds.at(module->name)).second) {
+            continue;
         }
+        loadCustomVoter(module->name, *c);
+        loadTimingLibrary(module->name, *c);
+    }
+
+    Yosys::log("Resolved %zu module configuration(s) to %zu distinct config(s)\n",
+               moduleCfgIds.size(), internedCfgs.size());
 
-        if (module->get_blackbox_attribute()) {
-            groupAssignments[modName].push_back(cfg_default_black_box_module_group_name);
+    // Whenever the config file had to be parsed, the cache missed or did not
+    // cover one of these modules; (re)write it with what is resolved now.
+    if (!cachePath.empty() && configFileLoaded) {
+        writeConfigCache();
+    }
+}
+
+// The key covers everything a resolved config depends on: the cache format,
+// the plugin build, the Config layout, the config file contents and, per
+// design module, its name, black-box state and TMRX attributes.
+std::string ConfigManager::configCacheKey(const std::string &configFile) const {
+    ConfigKeyWriter w;
+    w.add(std::string(tmrx_config_cache_magic));
+    w.add(tmrx_config_cache_version);
+    w.add(pluginBuildId());
+    ConfigFieldCounter fields;
+    visitConfigFields(globalCfg, fields);
+    w.add(fields.count);
+
+    std::ifstream in(configFile, std::ios::binary);
+    std::stringstream contents;
+    if (in) {
+        contents << in.rdbuf();
+    }
+    w.add(contents.str());
+
+    for (auto name : sortedNames(designModules)) {
+        const Yosys::RTLIL::Module *module = design->module(name);
+        w.add(name.str());
+        w.add(module->get_blackbox_attribute());
+        w.add(module->has_memories());
+        w.add(module->has_processes());
+
+        std::vector<std::pair<std::string, std::string>> attrs;
+        for (const auto &attr : module->attributes) {
+            if (attr.first.begins_with("\\tmrx_")) {
+                attrs.push_back({attr.first.str(), attr.second.as_string()});
+            }
+        }
+        std::sort(attrs.begin(), attrs.end());
+        w.add(static_cast<long long>(attrs.size()));
+        for (const auto &attr : attrs) {
+            w.add(attr.first);
+            w.add(attr.second);
         }
+    }
+
+    return contentHash(w.key);
+}
 
-        // Yosys::log_header(design, "creating id string");
-        moduleAttrCfgs[modName] = parseModuleAnnotations(module);
+// Cache file layout, in ConfigKeyWriter encoding: magic, key, global config,
+// the distinct configs, (module name, config index) for every resolved
+// module, then the validateCfg warnings.
+bool ConfigManager::readConfigCache() {
+    TraceSpan span("config", "readConfigCache", cachePath);
+    std::ifstream in(cachePath, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string data = buffer.str();
+
+    ConfigKeyReader r(data);
+    std::string magic;
+    std::string key;
+    r.read(magic);
+    r.read(key);
+    if (!r.ok || magic != tmrx_config_cache_magic || key != cacheKey) {
+        return false;
     }
 
-    for (auto module : design->modules()) {
-        if (!(module->has_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE))) {
-            continue;
+    Config global = globalCfg;
+    visitConfigFields(global, r);
+
+    long long configCount = 0;
+    r.read(configCount);
+    std::vector<ConfigId> ids;
+    for (long long i = 0; r.ok && i < configCount; i++) {
+        Config c = globalCfg;
+        visitConfigFields(c, r);
+        ids.push_back(internConfig(c));
+    }
+
+    long long moduleCount = 0;
+    r.read(moduleCount);
+    for (long long i = 0; r.ok && i < moduleCount; i++) {
+        std::string name;
+        long long index = 0;
+        r.read(name);
+        r.read(index);
+        if (index < 0 || static_cast<size_t>(index) >= ids.size() ||
+            designModules.count(name) == 0) {
+            r.ok = false;
+            break;
         }
+        moduleCfgIds[name] = ids.at(index);
+    }
+
+    long long warningCount = 0;
+    r.read(warningCount);
+    std::vector<std::string> warnings;
+    for (long long i = 0; r.ok && i < warningCount; i++) {
+        std::string warning;
+        r.read(warning);
+        warnings.push_back(warning);
+    }
 
-        Yosys::RTLIL::IdString specificModName = module->name;
-        Yosys::RTLIL::IdString modName = specificModName.str().substr(
-            0, specificModName.str().find(cfg_specific_module_separator));
+    if (!r.ok || !r.atEnd()) {
+        Yosys::log_warning("Ignoring damaged config cache file '%s'.\n", cachePath.c_str());
+        internedCfgs.clear();
+        internedCfgIds.clear();
+        moduleCfgIds.clear();
+        return false;
+    }
 
-        std::vector<ConfigPart> cfgParts = {globalConfigPart};
+    globalCfg = global;
+    for (const auto &warning : warnings) {
+        cfgWarning(warning);
+    }
+    return true;
+}
 
-        // Add group configs for both generic and specific module names
-        appendGroupConfigs(cfgParts, groupAssignments, modName, specificModName);
-        appendGroupConfigs(cfgParts, groupAssignments, specificModName, specificModName);
+void ConfigManager::writeConfigCache() {
+    TraceSpan span("config", "writeConfigCache", cachePath);
 
-        // Add module-specific configs in precedence order
-        appendConfigIfPresent(cfgParts, moduleCfgs, modName);
-        appendConfigIfPresent(cfgParts, moduleAttrCfgs, specificModName);
-        appendConfigIfPresent(cfgParts, specificModuleCfgs, specificModName);
+    // Only the modules resolved so far are stored; a run that asks for
+    // another one parses the config file for it.
+    ConfigKeyWriter w;
+    w.add(std::string(tmrx_config_cache_magic));
+    w.add(cacheKey);
+    visitConfigFields(globalCfg, w);
 
-        // TODO: validate cfg and enforce some values
-        finalModuleCfgs[specificModName] = assembleConfig(cfgParts, globalCfg);
+    Yosys::dict<ConfigId, long long> indices;
+    for (const auto &entry : moduleCfgIds) {
+        indices.insert({entry.second, static_cast<long long>(indices.size())});
+    }
+    std::vector<ConfigId> byIndex(indices.size());
+    for (const auto &entry : indices) {
+        byIndex[entry.second] = entry.first;
+    }
+    w.add(static_cast<long long>(byIndex.size()));
+    for (ConfigId id : byIndex) {
+        visitConfigFields(*internedCfgs.at(id), w);
     }
 
-    // Also assemble configs for non-submodule modules (e.g., the top-level chip).
-    // These have no '$' in their name, so modName == specificModName.
-    for (auto module : design->modules()) {
-        if (module->has_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE)) {
-            continue;
-        }
+    w.add(static_cast<long long>(moduleCfgIds.size()));
+    for (const auto &entry : moduleCfgIds) {
+        w.add(entry.first.str());
+        w.add(indices.at(entry.second));
+    }
 
-        Yosys::RTLIL::IdString modName = module->name;
+    w.add(static_cast<long long>(cfgWarnings.size()));
+    for (const auto &warning : cfgWarnings) {
+        w.add(warning);
+    }
 
-        std::vector<ConfigPart> cfgParts = {globalConfigPart};
-        appendGroupConfigs(cfgParts, groupAssignments, modName, modName);
-        appendConfigIfPresent(cfgParts, moduleCfgs, modName);
-        appendConfigIfPresent(cfgParts, moduleAttrCfgs, modName);
+    if (!writeFileAtomically(cachePath, w.key)) {
+        Yosys::log_warning("Can't write config cache file '%s'.\n", cachePath.c_str());
+        return;
+    }
+    Yosys::log("Wrote %zu module configuration(s) to config cache '%s'\n", moduleCfgIds.size(),
+               cachePath.c_str());
+}
 
-        finalModuleCfgs[modName] = assembleConfig(cfgParts, globalCfg);
+ConfigManager::ConfigId ConfigManager::internConfig(const Config &cfg) const {
+    std::string key = configKey(cfg);
+    auto known = internedCfgIds.find(key);
+    if (known != internedCfgIds.end()) {
+        return known->second;
     }
 
-    loadCustomVoters(design);
-    validateCfg(design);
+    ConfigId id = internedCfgs.size();
+    internedCfgs.push_back(std::make_unique<const Config>(cfg));
+    internedCfgIds[key] = id;
+    return id;
+}
+
+const Config *ConfigManager::setModuleConfig(Yosys::RTLIL::IdString modName,
+                                             const Config &cfg) const {
+    ConfigId id = internConfig(cfg);
+    moduleCfgIds[modName] = id;
+    return internedCfgs.at(id).get();
 }
 
 const Config *ConfigManager::getConfig(Yosys::RTLIL::Module *mod) const {
-    if (finalModuleCfgs.count(mod->name) == 0) {
+    auto id = moduleCfgIds.find(mod->name);
+    if (id != moduleCfgIds.end()) {
+        return internedCfgs.at(id->second).get();
+    }
+    if (designModules.count(mod->name) == 0) {
         return &globalCfg;
     }
 
-    return &finalModuleCfgs.at(mod->name);
+    loadConfigFile();
+    return resolveConfig(mod);
 }
 
 std::string ConfigManager::getConfigAsString(Yosys::RTLIL::Module *mod) const {
@@ -1059,10 +1690,15 @@ std::string ConfigManager::getConfigAsString(Yosys::RTLIL::Module *mod) const {
             ret += "TMR-Voter Reset Net: " + c->tmrVoterResetNet + "\n";
     }
     ret += "TMR-Voter Safe Mode: " + boolToString(c->tmrVoterSafeMode) + "\n";
+    ret += "TMR-Voter Word Level: " + boolToString(c->tmrVoterWordLevel) + "\n";
     ret += "Preserve Mod Ports: " + boolToString(c->preserveModulePorts) + "\n";
     ret += "Prevent Renaming: " + boolToString(c->preventRenaming) + "\n";
     ret += "Logic.insertVoterBeforeFf: " + boolToString(c->insertVoterBeforeFf) + "\n";
     ret += "Logic.insertVoterAfterFf: " + boolToString(c->insertVoterAfterFf) + "\n";
+    ret += "Logic.ffVoterPlacement: " + ffVoterPlacementToString(c->ffVoterPlacement) + "\n";
+    ret += "Logic.timingModel: " + timingModelToString(c->timingModel) + "\n";
+    if (c->timingModel == TimingModel::Liberty)
+        ret += "Logic.timingLibertyFile: " + c->timingLibertyFile + "\n";
     ret += "Full Module.insert_voter_before_modules: " +
            boolToString(c->tmrModeFullModuleInsertVoterBeforeModules) + "\n";
     ret += "Full Module.insert_voter_after_modules: " +
@@ -1071,6 +1707,7 @@ std::string ConfigManager::getConfigAsString(Yosys::RTLIL::Module *mod) const {
            boolToString(c->tmrModeFullModuleInsertVoterOnClockNets) + "\n";
     ret += "Full Module.insert_voter_on_reset_nets: " +
            boolToString(c->tmrModeFullModuleInsertVoterOnResetNets) + "\n";
+    ret += "Full Module.shared_worker: " + boolToString(c->tmrModeFullModuleSharedWorker) + "\n";
     ret += "Clock port names: " + poolToString(c->clockPortNames) + "\n";
     ret += "Expand Clock net: " + boolToString(c->expandClock) + "\n";
     ret += "Reset port names: " + poolToString(c->resetPortNames) + "\n";
@@ -1084,6 +1721,8 @@ std::string ConfigManager::getConfigAsString(Yosys::RTLIL::Module *mod) const {
     if (!c->errorPortName.empty())
         ret += "Error port name: " + c->errorPortName + "\n";
     ret += "Auto error port: " + boolToString(c->autoErrorPort) + "\n";
+    ret += "Error tree fan-in: " + std::to_string(c->errorTreeFanIn) + "\n";
+    ret += "Error register levels: " + std::to_string(c->errorRegisterLevels) + "\n";
 
     return ret;
 }
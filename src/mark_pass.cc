@@ -1,4 +1,5 @@
 #include "tmrx.h"
+#include "tmrx_constants.h"
 #include "utils.h"
 
 USING_YOSYS_NAMESPACE
@@ -12,23 +13,37 @@ struct TmrxMarkPass : public Pass {
         log_header(design, "Executing Mark Flip Flop Pass\n");
         log_push();
 
-        TMRX::ffSources.clear();
-
         for (auto module : design->modules()) {
             if (design->selected(module) && !module->get_blackbox_attribute()) {
                 int ff_count = 0;
                 int submod_count = 0;
+                pool<std::string> sources;
 
+                // Tag the flip-flops themselves, and keep their source
+                // locations in the design so cells rebuilt by a mapping pass
+                // (which only preserves `src`) can be recognised by tmrx.
+                // Merged `src` values are recorded per location.
                 for (auto cell : module->cells()) {
                     if (RTLIL::builtin_ff_cell_types().count(cell->type) > 0) {
                         ff_count++;
-                        if (cell->has_attribute(ID::src)) {
-                            std::string src = cell->get_string_attribute(ID::src);
-                            TMRX::ffSources[module->name].insert(src);
+                        cell->set_bool_attribute(TMRX::ATTRIBUTE_FF);
+                        for (auto &src : cell->get_strpool_attribute(ID::src)) {
+                            sources.insert(src);
                         }
                     }
                 }
 
+                std::string joined;
+                for (auto &src : sources) {
+                    if (!joined.empty()) {
+                        joined += TMRX::tmrx_ff_source_separator;
+                    }
+                    joined += src;
+                }
+                if (!joined.empty()) {
+                    module->set_string_attribute(TMRX::ATTRIBUTE_FF_SOURCES, joined);
+                }
+
                 // mark submodules
                 for (auto c : module->cells()) {
                     if (design->module(c->type) != nullptr) {
@@ -1,11 +0,0 @@
-#include "tmrx.h"
-
-YOSYS_NAMESPACE_BEGIN
-
-namespace TMRX {
-
-dict<RTLIL::IdString, pool<std::string>> ffSources;
-
-} // namespace TMRX
-
-YOSYS_NAMESPACE_END
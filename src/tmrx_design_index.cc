@@ -0,0 +1,107 @@
+#include "tmrx_design_index.h"
+#include "kernel/rtlil.h"
+#include "kernel/yosys.h"
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+DesignIndex::DesignIndex(RTLIL::Design *design) : design(design) {
+    for (auto module : design->modules()) {
+        addModule(module);
+    }
+}
+
+void DesignIndex::addCell(const RTLIL::Cell *cell) {
+    if (design->module(cell->type) != nullptr) {
+        instances[cell->type]++;
+    }
+}
+
+void DesignIndex::retypeCell(RTLIL::Cell *cell, RTLIL::IdString type) {
+    release(cell->type);
+    cell->type = type;
+    addCell(cell);
+}
+
+void DesignIndex::addModule(const RTLIL::Module *module) {
+    for (auto cell : module->cells()) {
+        addCell(cell);
+    }
+}
+
+// Drops the instances held by `module` and removes it from the design.
+void DesignIndex::removeModule(RTLIL::Module *module) {
+    for (auto cell : module->cells()) {
+        release(cell->type);
+    }
+    invalidatePorts(module->name);
+    design->remove(module);
+}
+
+size_t DesignIndex::instanceCount(RTLIL::IdString type) const {
+    auto it = instances.find(type);
+    return it == instances.end() ? 0 : it->second;
+}
+
+const ModulePorts *DesignIndex::modulePorts(RTLIL::IdString type) {
+    auto it = ports.find(type);
+    if (it != ports.end()) {
+        return &it->second;
+    }
+
+    RTLIL::Module *module = design->module(type);
+    if (module == nullptr) {
+        return nullptr;
+    }
+
+    module->fixup_ports();
+    ModulePorts &entry = ports[type];
+    for (auto port : module->ports) {
+        RTLIL::Wire *wire = module->wire(port);
+        entry.order.push_back(port);
+        entry.info[port] = {wire->port_input, wire->port_output, wire->width};
+    }
+    return &entry;
+}
+
+const PortInfo *DesignIndex::portInfo(RTLIL::IdString type, RTLIL::IdString port) {
+    const ModulePorts *entry = modulePorts(type);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    auto it = entry->info.find(port);
+    return it == entry->info.end() ? nullptr : &it->second;
+}
+
+// Internal cell types are answered by the cell library; design modules by
+// the cached port table (a name that is not a port is neither direction).
+bool DesignIndex::isPortInput(const RTLIL::Cell *cell, RTLIL::IdString port) {
+    if (design->module(cell->type) == nullptr) {
+        return cell->input(port);
+    }
+    const PortInfo *info = portInfo(cell->type, port);
+    return info != nullptr && info->input;
+}
+
+bool DesignIndex::isPortOutput(const RTLIL::Cell *cell, RTLIL::IdString port) {
+    if (design->module(cell->type) == nullptr) {
+        return cell->output(port);
+    }
+    const PortInfo *info = portInfo(cell->type, port);
+    return info != nullptr && info->output;
+}
+
+void DesignIndex::invalidatePorts(RTLIL::IdString type) { ports.erase(type); }
+
+void DesignIndex::release(RTLIL::IdString type) {
+    auto it = instances.find(type);
+    if (it == instances.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        instances.erase(it);
+    }
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
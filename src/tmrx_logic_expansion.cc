@@ -2,8 +2,13 @@
 #include "config_manager.h"
 #include "kernel/log.h"
 #include "kernel/rtlil.h"
+#include "tmrx_stats.h"
+#include "tmrx_timing.h"
+#include "tmrx_trace.h"
 #include "tmrx_utils.h"
-#include "utils.h"
+#include "tmrx_voter_placement.h"
+
+#include <optional>
 
 YOSYS_NAMESPACE_BEGIN
 namespace TMRX {
@@ -15,6 +20,17 @@ using detail::PortShape;
 using detail::ResolvedSubmodule;
 using detail::TriplicatedSignals;
 
+using TriplicatedBitMap = dict<RTLIL::SigBit, std::pair<RTLIL::SigBit, RTLIL::SigBit>>;
+using FlipFlopReplicas = dict<RTLIL::Cell *, std::pair<RTLIL::Cell *, RTLIL::Cell *>>;
+
+// Path B and path C replicas of a module's original logic, keyed by the
+// original (path A) object.
+struct ReplicatedLogic {
+    TriplicatedBitMap replicaBits;
+    dict<RTLIL::Wire *, std::pair<RTLIL::Wire *, RTLIL::Wire *>> outputMap;
+    dict<RTLIL::Cell *, std::pair<RTLIL::Cell *, RTLIL::Cell *>> flipFlopMap;
+};
+
 Yosys::pool<RTLIL::SigSpec> clkNetWires;
 Yosys::pool<RTLIL::SigSpec> rstNetWires;
 
@@ -42,18 +58,21 @@ bool shouldKeepWireShared(const RTLIL::Wire *wire, const Config *cfg) {
            (isRstWire(wire, cfg) && !cfg->expandReset);
 }
 
-bool isExposedModulePort(const RTLIL::Wire *wire) {
-    return wire != nullptr && (wire->port_input || wire->port_output);
-}
-
-TriplicatedSignals deriveParentSignals(
-    const RTLIL::SigSpec &signalA,
-    const dict<RTLIL::SigSpec, std::pair<RTLIL::SigSpec, RTLIL::SigSpec>> &wireMap) {
-    TriplicatedSignals signals = {signalA, signalA, signalA};
-
-    for (auto &kv : wireMap) {
-        signals.signalB.replace(kv.first, kv.second.first);
-        signals.signalC.replace(kv.first, kv.second.second);
+// Bits without an entry (shared wires, constants) are kept as they are, so
+// remapping costs one lookup per bit instead of one replace per wire.
+TriplicatedSignals deriveParentSignals(const RTLIL::SigSpec &signalA,
+                                       const TriplicatedBitMap &replicaBits) {
+    TriplicatedSignals signals = {signalA, {}, {}};
+
+    for (auto &bit : signalA.bits()) {
+        auto it = replicaBits.find(bit);
+        if (it == replicaBits.end()) {
+            signals.signalB.append(bit);
+            signals.signalC.append(bit);
+            continue;
+        }
+        signals.signalB.append(it->second.first);
+        signals.signalC.append(it->second.second);
     }
 
     return signals;
@@ -76,16 +95,16 @@ PortKind classifyPortKind(const RTLIL::Wire *portWire, const Config *childCfg) {
     return PortKind::Data;
 }
 
-ChildPortNames resolveChildPortNames(RTLIL::Module *effectiveCellMod, RTLIL::IdString logicalPort,
-                                     const Config *childCfg) {
+ChildPortNames resolveChildPortNames(DesignIndex *index, RTLIL::Module *effectiveCellMod,
+                                     RTLIL::IdString logicalPort, const Config *childCfg) {
     RTLIL::IdString portA = RTLIL::IdString(logicalPort.str() + childCfg->logicPath1Suffix);
     RTLIL::IdString portB = RTLIL::IdString(logicalPort.str() + childCfg->logicPath2Suffix);
     RTLIL::IdString portC = RTLIL::IdString(logicalPort.str() + childCfg->logicPath3Suffix);
 
-    bool hasBase = isExposedModulePort(effectiveCellMod->wire(logicalPort));
-    bool hasA = isExposedModulePort(effectiveCellMod->wire(portA));
-    bool hasB = isExposedModulePort(effectiveCellMod->wire(portB));
-    bool hasC = isExposedModulePort(effectiveCellMod->wire(portC));
+    bool hasBase = index->portInfo(effectiveCellMod->name, logicalPort) != nullptr;
+    bool hasA = index->portInfo(effectiveCellMod->name, portA) != nullptr;
+    bool hasB = index->portInfo(effectiveCellMod->name, portB) != nullptr;
+    bool hasC = index->portInfo(effectiveCellMod->name, portC) != nullptr;
 
     if (hasBase && !hasA && !hasB && !hasC) {
         return {PortShape::Shared, logicalPort, logicalPort, logicalPort};
@@ -104,20 +123,20 @@ ChildPortNames resolveChildPortNames(RTLIL::Module *effectiveCellMod, RTLIL::IdS
               effectiveCellMod->name.c_str());
 }
 
-void connectParentDestinations(RTLIL::Module *mod, const TriplicatedSignals &destinations,
+void connectParentDestinations(AnalysisContext &ctx, const TriplicatedSignals &destinations,
                                const RTLIL::SigSpec &source) {
-    mod->connect(destinations.signalA, source);
+    ctx.connect(destinations.signalA, source);
     if (destinations.signalB != destinations.signalA) {
-        mod->connect(destinations.signalB, source);
+        ctx.connect(destinations.signalB, source);
     }
     if (destinations.signalC != destinations.signalA &&
         destinations.signalC != destinations.signalB) {
-        mod->connect(destinations.signalC, source);
+        ctx.connect(destinations.signalC, source);
     }
 }
 
 ResolvedSubmodule resolveSubmodule(RTLIL::Module *mod, RTLIL::Cell *cell,
-                                   const ConfigManager *cfgMgr) {
+                                   const ConfigManager *cfgMgr, DesignIndex *index) {
     RTLIL::Module *logicalModule = mod->design->module(cell->type);
     if (logicalModule == nullptr) {
         log_error("No submodule definition found for cell '%s' (type '%s').\n", cell->name.c_str(),
@@ -131,7 +150,7 @@ ResolvedSubmodule resolveSubmodule(RTLIL::Module *mod, RTLIL::Cell *cell,
     if (wasExpandedWithTriplicatedPorts) {
         RTLIL::IdString implName =
             RTLIL::IdString(logicalModule->get_string_attribute(ATTRIBUTE_IMPL_MODULE));
-        cell->type = implName;
+        index->retypeCell(cell, implName);
         effectiveModule = mod->design->module(implName);
         if (effectiveModule == nullptr) {
             log_error("No remapped submodule implementation '%s' for cell '%s'.\n",
@@ -209,14 +228,16 @@ void buildRstNet(RTLIL::Module *mod, const ConfigManager *cfgMgr) {
 }
 
 std::vector<RTLIL::Wire *> connectSubmodulePorts(
-    RTLIL::Module *mod, RTLIL::Cell *cell, RTLIL::Module *logicalCellMod,
+    AnalysisContext &ctx, RTLIL::Cell *cell, RTLIL::Module *logicalCellMod,
     RTLIL::Module *effectiveCellMod, const Config *childCfg, const Config *parentCfg,
-    const dict<RTLIL::SigSpec, std::pair<RTLIL::SigSpec, RTLIL::SigSpec>> &wireMap) {
+    const TriplicatedBitMap &replicaBits) {
     std::vector<RTLIL::Wire *> errorSignals;
     if (!isProperSubmodule(logicalCellMod)) {
         return errorSignals;
     }
 
+    RTLIL::Module *mod = ctx.module;
+
     dict<RTLIL::IdString, RTLIL::SigSpec> origConnections;
     for (auto &conn : cell->connections()) {
         origConnections[conn.first] = conn.second;
@@ -224,11 +245,14 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
 
     cell->connections_.clear();
 
-    for (auto &port : effectiveCellMod->ports) {
+    const ModulePorts *effectivePorts = ctx.index->modulePorts(effectiveCellMod->name);
+    for (auto &port : effectivePorts->order) {
         RTLIL::Wire *portWire = effectiveCellMod->wire(port);
         if (origConnections.count(port) == 0 && isTmrErrorOutWire(portWire, childCfg)) {
-            RTLIL::Wire *err_wire = mod->addWire(NEW_ID, portWire->width);
+            RTLIL::Wire *err_wire = mod->addWire(NEW_ID, effectivePorts->info.at(port).width);
             cell->setPort(port, err_wire);
+            setErrorLatency(err_wire, errorLatency(portWire));
+            ctx.addDrivers(err_wire);
             errorSignals.push_back(err_wire);
         }
     }
@@ -236,28 +260,33 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
     for (auto &origConn : origConnections) {
         RTLIL::IdString logicalPort = origConn.first;
         RTLIL::Wire *logicalPortWire = logicalCellMod->wire(logicalPort);
+        const PortInfo *logicalPortInfo = ctx.index->portInfo(logicalCellMod->name, logicalPort);
         if (logicalPortWire == nullptr) {
             log_error("No logical port '%s' on submodule '%s'.\n", logicalPort.c_str(),
                       logicalCellMod->name.c_str());
         }
 
         PortKind portKind = classifyPortKind(logicalPortWire, childCfg);
-        ChildPortNames childPorts = resolveChildPortNames(effectiveCellMod, logicalPort, childCfg);
-        TriplicatedSignals parentSignals = deriveParentSignals(origConn.second, wireMap);
+        ChildPortNames childPorts =
+            resolveChildPortNames(ctx.index, effectiveCellMod, logicalPort, childCfg);
+        TriplicatedSignals parentSignals = deriveParentSignals(origConn.second, replicaBits);
         bool parentShared = parentSignalsAreShared(parentSignals);
 
-        if (logicalPortWire->port_input && logicalPortWire->port_output) {
+        bool logicalInput = logicalPortInfo != nullptr && logicalPortInfo->input;
+        bool logicalOutput = logicalPortInfo != nullptr && logicalPortInfo->output;
+
+        if (logicalInput && logicalOutput) {
             log_error("Inout port '%s' on submodule '%s' is not supported.\n", logicalPort.c_str(),
                       logicalCellMod->name.c_str());
         }
 
-        if (logicalPortWire->port_input) {
+        if (logicalInput) {
             if (childPorts.shape == PortShape::Shared) {
                 if (parentShared) {
                     cell->setPort(childPorts.portA, parentSignals.signalA);
                 } else {
                     auto [votedSignal, errorSignal] = insertVoter(
-                        mod, {parentSignals.signalA, parentSignals.signalB, parentSignals.signalC},
+                        ctx, {parentSignals.signalA, parentSignals.signalB, parentSignals.signalC},
                         parentCfg);
                     errorSignals.push_back(errorSignal);
                     cell->setPort(childPorts.portA, votedSignal);
@@ -276,7 +305,7 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
             continue;
         }
 
-        if (!logicalPortWire->port_output) {
+        if (!logicalOutput) {
             if (portKind == PortKind::Error) {
                 continue;
             }
@@ -287,7 +316,8 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
         if (childPorts.shape == PortShape::Shared) {
             RTLIL::Wire *newOutput = mod->addWire(NEW_ID, origConn.second.size());
             cell->setPort(childPorts.portA, newOutput);
-            connectParentDestinations(mod, parentSignals, newOutput);
+            ctx.addDrivers(newOutput);
+            connectParentDestinations(ctx, parentSignals, newOutput);
             continue;
         }
 
@@ -295,6 +325,9 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
             cell->setPort(childPorts.portA, parentSignals.signalA);
             cell->setPort(childPorts.portB, parentSignals.signalB);
             cell->setPort(childPorts.portC, parentSignals.signalC);
+            ctx.addDrivers(parentSignals.signalA);
+            ctx.addDrivers(parentSignals.signalB);
+            ctx.addDrivers(parentSignals.signalC);
             continue;
         }
 
@@ -304,23 +337,27 @@ std::vector<RTLIL::Wire *> connectSubmodulePorts(
         cell->setPort(childPorts.portA, outA);
         cell->setPort(childPorts.portB, outB);
         cell->setPort(childPorts.portC, outC);
+        ctx.addDrivers(outA);
+        ctx.addDrivers(outB);
+        ctx.addDrivers(outC);
 
-        auto [votedSignal, errorSignal] = insertVoter(mod, {outA, outB, outC}, parentCfg);
+        auto [votedSignal, errorSignal] = insertVoter(ctx, {outA, outB, outC}, parentCfg);
         errorSignals.push_back(errorSignal);
-        connectParentDestinations(mod, parentSignals, votedSignal);
+        connectParentDestinations(ctx, parentSignals, votedSignal);
     }
 
     return errorSignals;
 }
 
-std::vector<RTLIL::Wire *> insertVoterAfterFf(RTLIL::Module *mod,
-                                              dict<Cell *, std::pair<Cell *, Cell *>> ffMap,
-                                              const Config *cfg) {
+std::vector<RTLIL::Wire *>
+insertVoterAfterFf(AnalysisContext &ctx, const dict<Cell *, std::pair<Cell *, Cell *>> &ffMap,
+                   const Config *cfg) {
+    RTLIL::Module *mod = ctx.module;
     std::vector<RTLIL::Wire *> errorSignals;
 
     for (auto flipFlops : ffMap) {
 
-        auto [input_ports, output_ports] = getPortNames(flipFlops.first, mod->design);
+        auto [input_ports, output_ports] = getPortNames(flipFlops.first, ctx.index);
 
         if (output_ports.empty()) {
             log("Cell Type: %s\n", flipFlops.first->type.str().c_str());
@@ -336,17 +373,93 @@ std::vector<RTLIL::Wire *> insertVoterAfterFf(RTLIL::Module *mod,
                 RTLIL::Wire *intermediate_wire = mod->addWire(NEW_ID, out_signal.size());
 
                 ff->setPort(port, intermediate_wire);
+                ctx.addDrivers(intermediate_wire);
                 intermediateWires.push_back(intermediate_wire);
                 originalSignals.push_back(out_signal);
             }
 
             for (size_t i = 0; i < tmrx_replication_factor; i++) {
                 std::pair<RTLIL::Wire *, RTLIL::Wire *> resultWires =
-                    insertVoter(mod, intermediateWires, cfg,
+                    insertVoter(ctx, intermediateWires, cfg,
+                                i == 0 ? cfg->logicPath1Suffix
+                                       : (i == 1 ? cfg->logicPath2Suffix
+                                                 : cfg->logicPath3Suffix));
+                ctx.connect(originalSignals.at(i), resultWires.first);
+
+                errorSignals.push_back(resultWires.second);
+            }
+        }
+    }
+
+    return errorSignals;
+}
+
+// Input ports of a flip-flop that carry its next state, as opposed to clock,
+// reset and control pins. Builtin cells expose D (and AD on async-load
+// flip-flops); for cells configured through ff_cells every input that is not
+// a clock or reset port, and is not wired to the clock or reset net, is data.
+std::vector<RTLIL::IdString> getFfDataPorts(const RTLIL::Cell *cell, DesignIndex *index,
+                                            const Config *cfg) {
+    std::vector<RTLIL::IdString> dataPorts;
+
+    if (RTLIL::builtin_ff_cell_types().count(cell->type) > 0) {
+        for (auto port : {ID::D, ID::AD}) {
+            if (cell->hasPort(port)) {
+                dataPorts.push_back(port);
+            }
+        }
+        return dataPorts;
+    }
+
+    RTLIL::Module *cellMod = cell->module->design->module(cell->type);
+    for (auto &conn : cell->connections()) {
+        if (!index->isPortInput(cell, conn.first)) {
+            continue;
+        }
+        RTLIL::Wire *portWire = cellMod ? cellMod->wire(conn.first) : nullptr;
+        bool isClock = portWire ? isClkWire(portWire, cfg) : isClkWire(conn.first, cfg);
+        bool isReset = portWire ? isRstWire(portWire, cfg) : isRstWire(conn.first, cfg);
+        if (isClock || isReset || clkNetWires.count(conn.second) ||
+            rstNetWires.count(conn.second)) {
+            continue;
+        }
+        dataPorts.push_back(conn.first);
+    }
+
+    return dataPorts;
+}
+
+// Vote the next-state inputs of every flip-flop, so the voter delay sits in
+// front of the register instead of on its clock-to-Q launch path. Each domain
+// gets its own voter, as in insertVoterAfterFf. Inputs shared by all three
+// replicas (unexpanded nets, constants) carry no redundancy and are skipped.
+std::vector<RTLIL::Wire *>
+insertVoterBeforeFf(AnalysisContext &ctx, const dict<Cell *, std::pair<Cell *, Cell *>> &ffMap,
+                    const Config *cfg) {
+    std::vector<RTLIL::Wire *> errorSignals;
+
+    for (auto flipFlops : ffMap) {
+        std::vector<RTLIL::Cell *> replicas = {flipFlops.first, flipFlops.second.first,
+                                               flipFlops.second.second};
+
+        for (auto port : getFfDataPorts(flipFlops.first, ctx.index, cfg)) {
+            std::vector<RTLIL::SigSpec> nextState;
+            for (auto ff : replicas) {
+                nextState.push_back(ff->getPort(port));
+            }
+
+            if (ctx.sigmap(nextState.at(0)) == ctx.sigmap(nextState.at(1)) &&
+                ctx.sigmap(nextState.at(1)) == ctx.sigmap(nextState.at(2))) {
+                continue;
+            }
+
+            for (size_t i = 0; i < tmrx_replication_factor; i++) {
+                std::pair<RTLIL::Wire *, RTLIL::Wire *> resultWires =
+                    insertVoter(ctx, nextState, cfg,
                                 i == 0 ? cfg->logicPath1Suffix
                                        : (i == 1 ? cfg->logicPath2Suffix
                                                  : cfg->logicPath3Suffix));
-                mod->connect(originalSignals.at(i), resultWires.first);
+                replicas.at(i)->setPort(port, resultWires.first);
 
                 errorSignals.push_back(resultWires.second);
             }
@@ -357,9 +470,10 @@ std::vector<RTLIL::Wire *> insertVoterAfterFf(RTLIL::Module *mod,
 }
 
 std::vector<RTLIL::Wire *>
-insertOutputVoters(RTLIL::Module *mod,
-                   dict<RTLIL::Wire *, std::pair<RTLIL::Wire *, RTLIL::Wire *>> outputMap,
+insertOutputVoters(AnalysisContext &ctx,
+                   const dict<RTLIL::Wire *, std::pair<RTLIL::Wire *, RTLIL::Wire *>> &outputMap,
                    const Config *cfg) {
+    RTLIL::Module *mod = ctx.module;
     std::vector<RTLIL::Wire *> errorSignals;
     for (auto outputs : outputMap) {
         if (!cfg->preserveModulePorts && isInClkNet(outputs.first) && cfg->expandClock)
@@ -385,7 +499,7 @@ insertOutputVoters(RTLIL::Module *mod,
         // if(outputSignals.at(0) == outputSignals.at(1) && outputSignals.at(0) ==
         // outputSignals.at(2)) continue;
 
-        std::pair<RTLIL::Wire *, RTLIL::Wire *> resultWires = insertVoter(mod, outputSignals, cfg);
+        std::pair<RTLIL::Wire *, RTLIL::Wire *> resultWires = insertVoter(ctx, outputSignals, cfg);
         errorSignals.push_back(resultWires.second);
 
         resultWires.first->port_output = true;
@@ -416,32 +530,52 @@ void renameWiresAndCells(RTLIL::Module *mod, std::vector<RTLIL::Wire *> wires,
     }
 }
 
-std::tuple<dict<RTLIL::SigSpec, RTLIL::SigSpec>, dict<RTLIL::Wire *, RTLIL::Wire *>,
-           dict<RTLIL::Cell *, RTLIL::Cell *>>
-insertDuplicateLogic(RTLIL::Module *mod, std::vector<RTLIL::Wire *> wires,
-                     std::vector<RTLIL::Cell *> cells, std::vector<RTLIL::SigSig> connections,
-                     std::string suffix, const Config *cfg) {
-    dict<RTLIL::SigSpec, RTLIL::SigSpec> wireMap;
-    dict<RTLIL::Wire *, RTLIL::Wire *> outputMap;
-    dict<RTLIL::Cell *, RTLIL::Cell *> flipFlopMap;
+RTLIL::Wire *addReplicaWire(RTLIL::Module *mod, const RTLIL::Wire *w, const std::string &suffix) {
+    RTLIL::Wire *replica = mod->addWire(mod->uniquify(w->name.str() + suffix), w->width);
+    replica->port_input = w->port_input;
+    replica->port_output = w->port_output;
+    replica->start_offset = w->start_offset;
+    replica->upto = w->upto;
+    replica->attributes = w->attributes;
+    return replica;
+}
+
+RTLIL::Cell *addReplicaCell(RTLIL::Module *mod, DesignIndex *index, const RTLIL::Cell *c,
+                            const std::string &suffix) {
+    RTLIL::Cell *replica = mod->addCell(mod->uniquify(c->name.str() + suffix), c->type);
+    index->addCell(replica);
+    replica->parameters = c->parameters;
+    replica->attributes = c->attributes;
+    setCellDomainAttribute(replica, suffix);
+    return replica;
+}
+
+// Create the path B and path C replicas of the original wires, cells and
+// connections in a single walk. Both replicas are recorded side by side, so
+// later phases look up one entry per original object instead of zipping two
+// independently built maps.
+ReplicatedLogic insertReplicatedLogic(RTLIL::Module *mod, DesignIndex *index,
+                                      const std::vector<RTLIL::Wire *> &wires,
+                                      const std::vector<RTLIL::Cell *> &cells,
+                                      const std::vector<RTLIL::SigSig> &connections,
+                                      const Config *cfg) {
+    ReplicatedLogic logic;
 
     for (auto w : wires) {
         if (shouldKeepWireShared(w, cfg)) {
-            wireMap[w] = w;
             continue;
         }
 
-        RTLIL::Wire *w_b = mod->addWire(mod->uniquify(w->name.str() + suffix), w->width);
-        w_b->port_input = w->port_input;
-        w_b->port_output = w->port_output;
-        w_b->start_offset = w->start_offset;
-        w_b->upto = w->upto;
-        w_b->attributes = w->attributes;
+        RTLIL::Wire *w_b = addReplicaWire(mod, w, cfg->logicPath2Suffix);
+        RTLIL::Wire *w_c = addReplicaWire(mod, w, cfg->logicPath3Suffix);
 
-        wireMap[w] = w_b;
+        for (int i = 0; i < w->width; i++) {
+            logic.replicaBits[RTLIL::SigBit(w, i)] = {RTLIL::SigBit(w_b, i),
+                                                      RTLIL::SigBit(w_c, i)};
+        }
 
         if (w->port_output) {
-            outputMap[w] = w_b;
+            logic.outputMap[w] = {w_b, w_c};
         }
     }
 
@@ -450,49 +584,89 @@ insertDuplicateLogic(RTLIL::Module *mod, std::vector<RTLIL::Wire *> wires,
             continue;
         }
 
-        RTLIL::Cell *c_b = mod->addCell(mod->uniquify(c->name.str() + suffix), c->type);
-        setCellDomainAttribute(c_b, suffix);
-
-        // log("Looking at cell %u\n",
-        // (isFlipFlop(c, worker, &known_ff_cell_names)));
+        RTLIL::Cell *c_b = addReplicaCell(mod, index, c, cfg->logicPath2Suffix);
+        RTLIL::Cell *c_c = addReplicaCell(mod, index, c, cfg->logicPath3Suffix);
 
-        if (isFlipFlop(c, mod, cfg)) {
-            // TODO: fix this
-            flipFlopMap[c] = c_b;
+        if (isFlipFlop(c, cfg)) {
+            logic.flipFlopMap[c] = {c_b, c_c};
         }
 
-        c_b->parameters = c->parameters;
-        c_b->attributes = c->attributes;
-
         for (auto &connection : c->connections()) {
-            RTLIL::SigSpec sig = connection.second;
-
-            for (auto &it : wireMap) {
-                sig.replace(it.first, it.second);
-            }
-
-            c_b->setPort(connection.first, sig);
+            TriplicatedSignals signals = deriveParentSignals(connection.second, logic.replicaBits);
+            c_b->setPort(connection.first, signals.signalB);
+            c_c->setPort(connection.first, signals.signalC);
         }
     }
 
-    // TODO: imprive this
-    for (auto conn : connections) {
-        RTLIL::SigSpec first = conn.first;
-        RTLIL::SigSpec second = conn.second;
+    for (auto &conn : connections) {
+        TriplicatedSignals first = deriveParentSignals(conn.first, logic.replicaBits);
+        TriplicatedSignals second = deriveParentSignals(conn.second, logic.replicaBits);
+        mod->connect(first.signalB, second.signalB);
+        mod->connect(first.signalC, second.signalC);
+    }
 
-        for (auto &w : wireMap) {
-            first.replace(w.first, w.second);
-            second.replace(w.first, w.second);
+    return logic;
+}
+
+// Restrict `ffMap` to the flip-flops of a feedback cut of the original
+// netlist and report how many voter sites that saves over voting every one.
+// `cut` is computed before duplication, while path A is still untouched.
+// With a timing model each flip-flop is voted on one side only.
+void applyFeedbackCut(AnalysisContext &ctx, FlipFlopReplicas &ffMap,
+                      const pool<RTLIL::Cell *> &cut, const Config *cfg,
+                      const TimingAnalysis *timing) {
+    size_t flipFlops = ffMap.size();
+    size_t savedSites = 0;
+    FlipFlopReplicas kept;
+
+    for (auto &entry : ffMap) {
+        if (cut.count(entry.first)) {
+            kept.insert(entry);
+            continue;
+        }
+        if (timing != nullptr) {
+            size_t ports = timing->preferredSide(entry.first) == VoterSide::Before
+                               ? getFfDataPorts(entry.first, ctx.index, cfg).size()
+                               : getPortNames(entry.first, ctx.index).second.size();
+            savedSites += ports * tmrx_replication_factor;
+            continue;
+        }
+        if (cfg->insertVoterBeforeFf) {
+            savedSites +=
+                getFfDataPorts(entry.first, ctx.index, cfg).size() * tmrx_replication_factor;
         }
+        if (cfg->insertVoterAfterFf) {
+            savedSites +=
+                getPortNames(entry.first, ctx.index).second.size() * tmrx_replication_factor;
+        }
+    }
+
+    ffMap = std::move(kept);
+    log("    Feedback cut: voting %zu of %zu flip-flop(s), %zu voter site(s) saved compared to "
+        "per-FF placement\n",
+        ffMap.size(), flipFlops, savedSites);
+}
 
-        mod->connect(first, second);
+// Split the voted flip-flops by the side the timing model prefers and report
+// the estimated worst path of the module before and after TMR.
+void splitByTiming(const TimingAnalysis &timing, const FlipFlopReplicas &ffMap,
+                   const Config *cfg, FlipFlopReplicas &beforeFf, FlipFlopReplicas &afterFf) {
+    dict<RTLIL::Cell *, VoterSide> sides;
+    for (auto &entry : ffMap) {
+        VoterSide side = timing.preferredSide(entry.first);
+        sides[entry.first] = side;
+        (side == VoterSide::Before ? beforeFf : afterFf).insert(entry);
     }
 
-    return {wireMap, outputMap, flipFlopMap};
+    log("    Timing (%s): worst estimated path %g before TMR, %g after; voting %zu flip-flop(s) "
+        "on their inputs, %zu on their outputs\n",
+        timingModelToString(cfg->timingModel).c_str(), timing.worstPath(), timing.worstPath(sides),
+        beforeFf.size(), afterFf.size());
 }
 
 } // namespace
-void logicTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, const Config *cfgOverride) {
+void logicTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, DesignIndex *index,
+                       const Config *cfgOverride) {
     const Config *cfg = cfgOverride ? cfgOverride : cfgMgr->getConfig(mod);
 
     std::vector<RTLIL::Wire *> originalWires(mod->wires().begin(), mod->wires().end());
@@ -505,70 +679,160 @@ void logicTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, const Co
         originalWires.size(), originalCells.size());
 
     log("  [1/6] Building clock/reset nets\n");
+    StatsPhase netPhase("clock_reset_nets");
     buildClkNet(mod, cfgMgr);
     buildRstNet(mod, cfgMgr);
+    netPhase.end();
+
+    // Flip-flop voter placement is decided on the original netlist, before
+    // duplication and submodule connection rewire path A.
+    bool votesFlipFlops = cfg->insertVoterBeforeFf || cfg->insertVoterAfterFf;
+    bool feedbackCutPlacement =
+        votesFlipFlops && cfg->ffVoterPlacement == FfVoterPlacement::FeedbackCut;
+    bool timingPlacement = votesFlipFlops && cfg->timingModel != TimingModel::None;
+    std::optional<CellGraph> cellGraph;
+    std::optional<TimingAnalysis> timing;
+    pool<RTLIL::Cell *> feedbackCut;
+    if (feedbackCutPlacement || timingPlacement) {
+        StatsPhase placementPhase("ff_placement");
+        std::vector<RTLIL::Cell *> flipFlops;
+        for (auto c : originalCells) {
+            if (isLogicTreeCell(c, mod->design) && isFlipFlop(c, cfg)) {
+                flipFlops.push_back(c);
+            }
+        }
+        cellGraph.emplace(mod, originalCells, index);
+
+        dict<RTLIL::Cell *, double> criticality;
+        if (timingPlacement) {
+            DelayModel delays(cfg->timingModel, cfgMgr->getTimingLibrary(cfg->timingLibertyFile));
+            timing.emplace(*cellGraph, flipFlops, delays);
+            for (auto ff : flipFlops) {
+                criticality[ff] = timing->votedPath(ff);
+            }
+        }
+        if (feedbackCutPlacement) {
+            feedbackCut = selectFeedbackCutFlipFlops(*cellGraph, flipFlops,
+                                                     timing ? &criticality : nullptr);
+        }
+        // With triplicated ports, a loop through the parent reaches this
+        // module's flip-flops without passing a voter; preserved ports are
+        // voted at the boundary instead.
+        if (feedbackCutPlacement && !cfg->preserveModulePorts) {
+            std::vector<RTLIL::Wire *> inputs;
+            std::vector<RTLIL::Wire *> outputs;
+            for (auto w : originalWires) {
+                if (w->port_input && !isClkWire(w, cfg) && !isRstWire(w, cfg)) {
+                    inputs.push_back(w);
+                }
+                if (w->port_output) {
+                    outputs.push_back(w);
+                }
+            }
+            for (auto ff : selectBoundaryFlipFlops(*cellGraph, flipFlops, inputs, outputs)) {
+                feedbackCut.insert(ff);
+            }
+        }
+    }
 
     log("  [2/6] Duplicating logic (paths B and C)\n");
-    auto [wireMapB, outputMapB, flipFlopMapB] = insertDuplicateLogic(
-        mod, originalWires, originalCells, originalConnections, cfg->logicPath2Suffix, cfg);
-    auto [wireMapC, outputMapC, flipFlopMapC] = insertDuplicateLogic(
-        mod, originalWires, originalCells, originalConnections, cfg->logicPath3Suffix, cfg);
+    StatsPhase duplicationPhase("duplication");
+    ReplicatedLogic replicas =
+        insertReplicatedLogic(mod, index, originalWires, originalCells, originalConnections,
+                              cfg);
+    duplicationPhase.end();
 
+    StatsPhase rebuildNetPhase("clock_reset_nets");
     buildClkNet(mod, cfgMgr);
     buildRstNet(mod, cfgMgr);
+    rebuildNetPhase.end();
 
-    dict<RTLIL::Wire *, std::pair<RTLIL::Wire *, RTLIL::Wire *>> combinedOutputMap =
-        zipDicts(outputMapB, outputMapC);
-    dict<RTLIL::SigSpec, std::pair<RTLIL::SigSpec, RTLIL::SigSpec>> combinedWireMap =
-        zipDicts(wireMapB, wireMapC);
-    dict<RTLIL::Cell *, std::pair<RTLIL::Cell *, RTLIL::Cell *>> combinedFfMap =
-        zipDicts(flipFlopMapB, flipFlopMapC);
+    // One SigMap / driver index for every voter inserted below; kept current
+    // incrementally instead of being rebuilt per voter.
+    StatsPhase indexPhase("netlist_index");
+    AnalysisContext ctx(mod, index);
+    indexPhase.end();
 
     log("  [3/6] Connecting submodule ports\n");
+    StatsPhase submodulePhase("submodule_connection");
     for (auto cell : originalCells) {
         RTLIL::Module *cellMod = mod->design->module(cell->type);
         // Blackbox cells (standard cells, liberty cells) are duplicated like
-        // primitive cells in insertDuplicateLogic; they must not be treated
+        // primitive cells in insertReplicatedLogic; they must not be treated
         // as proper submodules here or voters get inserted on every port.
         if (!isProperSubmodule(cellMod) || cellMod->get_blackbox_attribute()) {
             continue;
         }
 
-        ResolvedSubmodule submodule = resolveSubmodule(mod, cell, cfgMgr);
+        ResolvedSubmodule submodule = resolveSubmodule(mod, cell, cfgMgr, index);
 
         log("    Connecting submodule '%s' (type '%s', preserve_ports=%s, expanded=%s)\n",
             cell->name.c_str(), cell->type.c_str(),
             submodule.childCfg->preserveModulePorts ? "true" : "false",
             submodule.wasExpandedWithTriplicatedPorts ? "true" : "false");
 
+        TraceSpan span("voter", "submodule voters", log_id(cell));
         auto voterErrorWires =
-            connectSubmodulePorts(mod, cell, submodule.logicalModule, submodule.effectiveModule,
-                                  submodule.childCfg, cfg, combinedWireMap);
+            connectSubmodulePorts(ctx, cell, submodule.logicalModule, submodule.effectiveModule,
+                                  submodule.childCfg, cfg, replicas.replicaBits);
         errorWires.insert(errorWires.end(), voterErrorWires.begin(), voterErrorWires.end());
     }
+    submodulePhase.end();
 
     log("  [4/6] Renaming path-A wires/cells\n");
+    StatsPhase renamePhase("renaming");
     renameWiresAndCells(mod, originalWires, originalCells, cfg->logicPath1Suffix, cfg);
+    renamePhase.end();
+
+    if (feedbackCutPlacement) {
+        applyFeedbackCut(ctx, replicas.flipFlopMap, feedbackCut, cfg, timing ? &*timing : nullptr);
+    }
 
-    if (cfg->insertVoterBeforeFf) {
-        log_error("Insert before ff not yet implemented");
+    FlipFlopReplicas beforeFf;
+    FlipFlopReplicas afterFf;
+    if (timing) {
+        splitByTiming(*timing, replicas.flipFlopMap, cfg, beforeFf, afterFf);
+    } else {
+        if (cfg->insertVoterBeforeFf)
+            beforeFf = replicas.flipFlopMap;
+        if (cfg->insertVoterAfterFf)
+            afterFf = replicas.flipFlopMap;
     }
 
-    if (cfg->insertVoterAfterFf) {
-        log("  [5/6] Inserting voters after %zu flip-flop(s)\n", combinedFfMap.size());
-        auto voterErrorWires = insertVoterAfterFf(mod, combinedFfMap, cfg);
+    if (cfg->insertVoterBeforeFf || timing) {
+        log("  [5/6] Inserting voters before %zu flip-flop(s)\n", beforeFf.size());
+        StatsPhase ffPhase("ff_voting");
+        TraceSpan span("voter", "ff input voters", log_id(mod));
+        auto voterErrorWires = insertVoterBeforeFf(ctx, beforeFf, cfg);
         errorWires.insert(errorWires.end(), voterErrorWires.begin(), voterErrorWires.end());
     }
 
+    if (cfg->insertVoterAfterFf || timing) {
+        log("  [5/6] Inserting voters after %zu flip-flop(s)\n", afterFf.size());
+        StatsPhase ffPhase("ff_voting");
+        TraceSpan span("voter", "ff voters", log_id(mod));
+        auto voterErrorWires = insertVoterAfterFf(ctx, afterFf, cfg);
+        errorWires.insert(errorWires.end(), voterErrorWires.begin(), voterErrorWires.end());
+    }
+
+    StatsPhase finalNetPhase("clock_reset_nets");
     buildClkNet(mod, cfgMgr);
     buildRstNet(mod, cfgMgr);
+    finalNetPhase.end();
 
     log("  [6/6] Inserting output voters / connecting error signal\n");
     if (cfg->preserveModulePorts || !cfg->expandClock || !cfg->expandReset) {
-        auto voterErrorWires = insertOutputVoters(mod, combinedOutputMap, cfg);
+        StatsPhase outputPhase("output_voting");
+        TraceSpan span("voter", "output voters", log_id(mod));
+        auto voterErrorWires = insertOutputVoters(ctx, replicas.outputMap, cfg);
         errorWires.insert(errorWires.end(), voterErrorWires.begin(), voterErrorWires.end());
     }
 
+    if (ctx.reusedVoters != 0) {
+        log("    Reused existing voters for %zu repeated input triple(s)\n", ctx.reusedVoters);
+    }
+
+    StatsPhase errorPhase("error_wiring");
     connectErrorSignal(mod, errorWires, cfg);
 }
 
@@ -1,5 +1,7 @@
 #include "tmrx_mod_expansion.h"
 #include "kernel/rtlil.h"
+#include "tmrx_stats.h"
+#include "tmrx_trace.h"
 #include "tmrx_utils.h"
 
 YOSYS_NAMESPACE_BEGIN
@@ -27,7 +29,8 @@ bool isRecursiveDomainAttrExempt(RTLIL::Module *mod, const ConfigManager *cfgMgr
 // appending `suffix` to their type names.  Creates new uniquified module
 // definitions in `design` as needed (skips creation if already present).
 void uniquifySubmodulesRecursive(RTLIL::Module *mod, const std::string &suffix,
-                                 RTLIL::Design *design, const ConfigManager *cfgMgr) {
+                                 RTLIL::Design *design, DesignIndex *index,
+                                 const ConfigManager *cfgMgr) {
     std::vector<RTLIL::Cell *> cells(mod->cells().begin(), mod->cells().end());
 
     for (auto cell : cells) {
@@ -57,6 +60,7 @@ void uniquifySubmodulesRecursive(RTLIL::Module *mod, const std::string &suffix,
             RTLIL::Module *uniqueMod = design->addModule(uniqueName);
             cellMod->cloneInto(uniqueMod);
             uniqueMod->name = uniqueName;
+            index->addModule(uniqueMod);
             uniqueMod->set_bool_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE, true);
             // cloneInto copies all attributes, including tmrx_impl_module if
             // the source was processed by TMRX. The clone is an independent
@@ -65,16 +69,17 @@ void uniquifySubmodulesRecursive(RTLIL::Module *mod, const std::string &suffix,
             uniqueMod->attributes.erase(ATTRIBUTE_IMPL_MODULE);
 
             // Recurse so deeper submodule levels are also uniquified.
-            uniquifySubmodulesRecursive(uniqueMod, suffix, design, cfgMgr);
+            uniquifySubmodulesRecursive(uniqueMod, suffix, design, index, cfgMgr);
         }
 
-        cell->type = uniqueName;
+        index->retypeCell(cell, uniqueName);
     }
 }
 
 } // namespace
 
-void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, const Config *cfg) {
+void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, DesignIndex *index,
+                            const Config *cfg) {
     std::vector<RTLIL::Wire *> errorWires;
 
     RTLIL::IdString originalModuleName = mod->name;
@@ -82,7 +87,9 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
         originalModuleName.c_str());
     std::string moduleName = mod->name.str() + tmrx_worker_module_suffix;
 
+    StatsPhase wrapperPhase("wrapper");
     mod->design->rename(mod, moduleName);
+    index->invalidatePorts(originalModuleName);
     RTLIL::Module *wrapper = mod->design->addModule(originalModuleName);
     wrapper->set_bool_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE);
     dict<RTLIL::Wire *, std::vector<RTLIL::Wire *>> wireMap;
@@ -124,6 +131,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
 
     for (size_t i = 0; i < tmrx_replication_factor; i++) {
         RTLIL::Cell *cell = wrapper->addCell(NEW_ID, moduleName);
+        index->addCell(cell);
         duplicates.push_back(cell);
 
         cellPorts.push_back({});
@@ -137,12 +145,22 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
             cell->setPort(w->name, w_con);
 
             if (isTmrErrorOutWire(w, cfg)) {
+                setErrorLatency(w_con, errorLatency(w));
                 errorWires.push_back(w_con);
             }
         }
     }
 
+    wrapperPhase.end();
+
+    StatsPhase indexPhase("netlist_index");
+    AnalysisContext ctx(wrapper, index);
+    indexPhase.end();
+
+    StatsPhase votingPhase("voting");
+
     if (cfg->tmrModeFullModuleInsertVoterBeforeModules && !cfg->preserveModulePorts) {
+        TraceSpan span("voter", "input voters", log_id(wrapper));
         for (auto wm : wireMap) {
             if (!wm.first->port_input || (isClkWire(wm.first, cfg) && !cfg->expandClock) ||
                 (isRstWire(wm.first, cfg) && !cfg->expandReset) ||
@@ -155,7 +173,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
 
             for (size_t i = 0; i < tmrx_replication_factor; i++) {
                 auto [voterOutput, err] =
-                    insertVoter(wrapper, {wm.second.at(0), wm.second.at(1), wm.second.at(2)}, cfg,
+                    insertVoter(ctx, {wm.second.at(0), wm.second.at(1), wm.second.at(2)}, cfg,
                                 suffixes.at(i));
                 errorWires.push_back(err);
                 voterOutputs.push_back(voterOutput);
@@ -166,6 +184,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
     }
 
     if (cfg->tmrModeFullModuleInsertVoterAfterModules && !cfg->preserveModulePorts) {
+        TraceSpan span("voter", "module output voters", log_id(wrapper));
         for (auto wm : wireMap) {
             if (!wm.first->port_output || isTmrErrorOutWire(wm.first, cfg) ||
                 (isClkWire(wm.first, cfg) && !cfg->expandClock) ||
@@ -179,7 +198,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
 
             for (size_t i = 0; i < tmrx_replication_factor; i++) {
                 auto [voterOutput, err] =
-                    insertVoter(wrapper,
+                    insertVoter(ctx,
                                 {cellPorts.at(0).at(wm.first), cellPorts.at(1).at(wm.first),
                                  cellPorts.at(2).at(wm.first)},
                                 cfg, suffixes.at(i));
@@ -194,6 +213,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
     }
 
     if (cfg->preserveModulePorts || !cfg->expandClock || !cfg->expandReset) {
+        TraceSpan span("voter", "output voters", log_id(wrapper));
         for (auto wm : wireMap) {
             if (!wm.first->port_output)
                 continue;
@@ -207,7 +227,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
                 continue;
 
             auto [voterOutput, err] =
-                insertVoter(wrapper,
+                insertVoter(ctx,
                             {cellPorts.at(0).at(wm.first), cellPorts.at(1).at(wm.first),
                              cellPorts.at(2).at(wm.first)},
                             cfg);
@@ -227,7 +247,15 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
         }
     }
 
+    votingPhase.end();
+
+    if (ctx.reusedVoters != 0) {
+        log("    Reused existing voters for %zu repeated input triple(s)\n", ctx.reusedVoters);
+    }
+
+    StatsPhase errorPhase("error_wiring");
     connectErrorSignal(wrapper, errorWires, cfg);
+    errorPhase.end();
 
     // Create one uniquified worker clone per TMR path and recursively uniquify
     // all proper submodule cells within each clone so that the three workers
@@ -238,6 +266,21 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
         cfg->logicPath3Suffix,
     };
 
+    StatsPhase workerPhase("workers");
+
+    // Shared worker: the three instances keep referencing the single worker
+    // definition and carry their TMR domain as an instance attribute, so the
+    // worker's submodule hierarchy is not copied at all.
+    if (cfg->tmrModeFullModuleSharedWorker) {
+        log("  Full Module TMR: sharing worker '%s' between %zu instances\n", moduleName.c_str(),
+            tmrx_replication_factor);
+        mod->set_bool_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE, true);
+        for (size_t i = 0; i < tmrx_replication_factor; i++) {
+            setCellDomainAttribute(duplicates[i], pathSuffixes[i]);
+        }
+        return;
+    }
+
     RTLIL::Design *design = mod->design;
     for (size_t i = 0; i < tmrx_replication_factor; i++) {
         RTLIL::IdString workerName = RTLIL::IdString(mod->name.str() + pathSuffixes[i]);
@@ -245,11 +288,12 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
         RTLIL::Module *worker = design->addModule(workerName);
         mod->cloneInto(worker);
         worker->name = workerName;
+        index->addModule(worker);
         worker->set_bool_attribute(ATTRIBUTE_IS_PROPER_SUBMODULE, true);
 
-        uniquifySubmodulesRecursive(worker, pathSuffixes[i], design, cfgMgr);
+        uniquifySubmodulesRecursive(worker, pathSuffixes[i], design, index, cfgMgr);
 
-        duplicates[i]->type = workerName;
+        index->retypeCell(duplicates[i], workerName);
     }
     // mod (the template worker) is no longer referenced by any cell.
     // Remove it immediately: the _a/_b/_c workers hold the complete
@@ -257,7 +301,7 @@ void fullModuleTmrExpansion(RTLIL::Module *mod, const ConfigManager *cfgMgr, con
     // as an unreachable orphan causes `stat -top` to crash because stat
     // iterates design->selected_modules() but only builds mod_stat for
     // modules reachable from the top (std::out_of_range on missing keys).
-    design->remove(mod);
+    index->removeModule(mod);
 }
 } // namespace TMRX
 
@@ -0,0 +1,280 @@
+#include "tmrx_module_cache.h"
+#include "backends/rtlil/rtlil_backend.h"
+#include "kernel/log.h"
+#include "kernel/rtlil.h"
+#include "tmrx_constants.h"
+#include "tmrx_trace.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+namespace {
+
+constexpr const char cacheRemoveTag[] = "# remove ";
+
+std::string dumpModule(RTLIL::Module *module) {
+    std::stringstream out;
+    RTLIL_BACKEND::dump_module(out, "", module, module->design, false);
+    return out.str();
+}
+
+// The RTLIL of `module` with the global counter in auto-generated names
+// (`$procdff$12`, `$auto$opt_dff.cc:764:run$31`) replaced by the order of
+// first appearance, so that an edit elsewhere in the design, which shifts the
+// counter, does not change the key. String literals are left alone.
+std::string canonicalDump(RTLIL::Module *module) {
+    std::string text = dumpModule(module);
+    dict<std::string, int> autoNames;
+    std::string result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+    while (i < text.size()) {
+        if (text[i] == '"') {
+            size_t end = i + 1;
+            while (end < text.size() && text[end] != '"') {
+                end += text[end] == '\\' ? 2 : 1;
+            }
+            end = std::min(end + 1, text.size());
+            result.append(text, i, end - i);
+            i = end;
+            continue;
+        }
+
+        bool tokenStart = i == 0 || std::isspace(static_cast<unsigned char>(text[i - 1]));
+        if (text[i] != '$' || !tokenStart) {
+            result += text[i++];
+            continue;
+        }
+
+        size_t end = i;
+        while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end]))) {
+            end++;
+        }
+        std::string token = text.substr(i, end - i);
+        size_t counter = token.rfind('$');
+        bool numbered = counter > 0 && counter + 1 < token.size() &&
+                        token.find_first_not_of("0123456789", counter + 1) == std::string::npos;
+        if (numbered) {
+            auto known = autoNames.find(token);
+            if (known == autoNames.end()) {
+                known = autoNames.insert({token, static_cast<int>(autoNames.size())}).first;
+            }
+            token = token.substr(0, counter + 1) + std::to_string(known->second);
+        }
+        result += token;
+        i = end;
+    }
+
+    return result;
+}
+
+// Fields are length-prefixed so that no two field sequences share a key.
+void appendField(std::string &key, const std::string &field) {
+    key += std::to_string(field.size());
+    key += ':';
+    key += field;
+}
+
+// The header repeats the key, so that a file that does not belong to the
+// key, e.g. one copied or renamed by hand, is never restored.
+std::string cacheHeader(const std::string &key) {
+    return stringf("# %s %d %s\n", tmrx_module_cache_magic, tmrx_module_cache_version,
+                   key.c_str());
+}
+
+} // namespace
+
+ModuleCache::ModuleCache(RTLIL::Design *design, const std::string &dir)
+    : design(design), dir(dir) {
+    for (auto module : design->modules()) {
+        initialModules.insert(module->name);
+    }
+}
+
+std::string ModuleCache::entryPath(const std::string &key) const {
+    return dir + "/" + key + tmrx_module_cache_suffix;
+}
+
+// Modules that are not expanded by this run are keyed by their content.
+std::string ModuleCache::contentKey(RTLIL::IdString name) {
+    auto known = keys.find(name);
+    if (known != keys.end()) {
+        return known->second;
+    }
+    std::string key = contentHash(canonicalDump(design->module(name)));
+    keys[name] = key;
+    return key;
+}
+
+std::string ModuleCache::moduleKey(RTLIL::Module *module, const Config *cfg) {
+    std::string key;
+    appendField(key, tmrx_module_cache_magic);
+    appendField(key, std::to_string(tmrx_module_cache_version));
+    appendField(key, yosys_version_str);
+    appendField(key, pluginBuildId());
+    appendField(key, configKey(*cfg));
+    appendField(key, canonicalDump(module));
+
+    pool<RTLIL::IdString> types;
+    for (auto cell : module->cells()) {
+        if (design->module(cell->type) != nullptr) {
+            types.insert(cell->type);
+        }
+    }
+    for (auto type : sortedNames(types)) {
+        appendField(key, type.str());
+        appendField(key, contentKey(type));
+    }
+
+    if (cfg->tmrVoter == TmrVoter::Custom) {
+        RTLIL::IdString templateName = makeRtlilId(cfg->tmrVoterModule);
+        appendField(key, design->module(templateName) ? contentKey(templateName) : "");
+    }
+    if (cfg->timingModel == TimingModel::Liberty) {
+        auto known = fileHashes.find(cfg->timingLibertyFile);
+        if (known == fileHashes.end()) {
+            std::ifstream in(cfg->timingLibertyFile, std::ios::binary);
+            std::stringstream contents;
+            contents << in.rdbuf();
+            known = fileHashes.insert({cfg->timingLibertyFile, contentHash(contents.str())}).first;
+        }
+        appendField(key, known->second);
+    }
+
+    std::string hash = contentHash(key);
+    keys[module->name] = hash;
+    return hash;
+}
+
+bool ModuleCache::restore(RTLIL::IdString name, const std::string &key, DesignIndex &index) {
+    TraceSpan span("cache", "restoreModule", log_id(name));
+    size_t added = 0;
+    if (!apply(name, key, index, added)) {
+        misses++;
+        return false;
+    }
+
+    log("  Restored '%s' from module cache '%s' (%zu module(s) added)\n", log_id(name),
+        entryPath(key).c_str(), added);
+    hits++;
+    return true;
+}
+
+bool ModuleCache::apply(RTLIL::IdString name, const std::string &key, DesignIndex &index,
+                        size_t &added) {
+    std::string path = entryPath(key);
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line + "\n" != cacheHeader(key)) {
+        return false;
+    }
+
+    std::vector<RTLIL::IdString> removed;
+    while (std::getline(in, line) && line.rfind(cacheRemoveTag, 0) == 0) {
+        removed.push_back(RTLIL::IdString(line.substr(strlen(cacheRemoveTag))));
+    }
+    in.close();
+
+    RTLIL::Design cached;
+    run_pass("read_rtlil " + path, &cached);
+    if (cached.module(name) == nullptr) {
+        log_warning("Ignoring module cache file '%s' without module '%s'.\n", path.c_str(),
+                    log_id(name));
+        return false;
+    }
+
+    for (auto removedName : removed) {
+        if (design->module(removedName) != nullptr) {
+            index.removeModule(design->module(removedName));
+        }
+    }
+
+    // Only the module itself replaces its unexpanded original. Other modules
+    // were created by TMRX; if they exist, an equal expansion in this run
+    // already created them.
+    std::vector<RTLIL::Module *> loaded;
+    for (auto source : cached.modules()) {
+        RTLIL::Module *existing = design->module(source->name);
+        if (existing != nullptr) {
+            if (initialModules.count(source->name) == 0) {
+                continue;
+            }
+            index.removeModule(existing);
+        }
+        RTLIL::Module *module = design->addModule(source->name);
+        source->cloneInto(module);
+        module->name = source->name;
+        loaded.push_back(module);
+    }
+    for (auto module : loaded) {
+        index.addModule(module);
+        index.invalidatePorts(module->name);
+    }
+
+    added = loaded.size();
+    return true;
+}
+
+void ModuleCache::beginExpansion() {
+    modulesBeforeExpansion.clear();
+    for (auto module : design->modules()) {
+        modulesBeforeExpansion.insert(module->name);
+    }
+}
+
+void ModuleCache::store(RTLIL::IdString name, const std::string &key) {
+    TraceSpan span("cache", "storeModule", log_id(name));
+
+    // The expanded module, the modules its expansion added and, transitively,
+    // the TMRX-created modules these instantiate.
+    pool<RTLIL::IdString> entry;
+    std::vector<RTLIL::IdString> queue;
+    auto addToEntry = [&](RTLIL::IdString moduleName) {
+        if (design->module(moduleName) != nullptr && entry.insert(moduleName).second) {
+            queue.push_back(moduleName);
+        }
+    };
+
+    addToEntry(name);
+    for (auto module : design->modules()) {
+        if (modulesBeforeExpansion.count(module->name) == 0) {
+            addToEntry(module->name);
+        }
+    }
+    while (!queue.empty()) {
+        RTLIL::Module *module = design->module(queue.back());
+        queue.pop_back();
+        for (auto cell : module->cells()) {
+            if (initialModules.count(cell->type) == 0) {
+                addToEntry(cell->type);
+            }
+        }
+    }
+
+    std::stringstream out;
+    out << cacheHeader(key);
+    for (auto beforeName : sortedNames(modulesBeforeExpansion)) {
+        if (design->module(beforeName) == nullptr) {
+            out << cacheRemoveTag << beforeName.str() << "\n";
+        }
+    }
+    for (auto moduleName : sortedNames(entry)) {
+        RTLIL_BACKEND::dump_module(out, "", design->module(moduleName), design, false);
+    }
+
+    std::string path = entryPath(key);
+    if (!writeFileAtomically(path, out.str())) {
+        log_warning("Can't write module cache file '%s'.\n", path.c_str());
+    }
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -0,0 +1,389 @@
+#include "tmrx_module_matcher.h"
+#include "kernel/log.h"
+
+#include <algorithm>
+#include <utility>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+
+using ByteSet = std::bitset<256>;
+
+namespace {
+
+ByteSet singleByte(char ch) {
+    ByteSet set;
+    set.set(static_cast<unsigned char>(ch));
+    return set;
+}
+
+ByteSet anyByte() { return ByteSet().set(); }
+
+ByteSet escapedBytes(char ch) {
+    ByteSet set;
+    switch (ch) {
+    case 'd':
+        for (char c = '0'; c <= '9'; c++)
+            set.set(static_cast<unsigned char>(c));
+        return set;
+    case 'w':
+        for (char c = '0'; c <= '9'; c++)
+            set.set(static_cast<unsigned char>(c));
+        for (char c = 'a'; c <= 'z'; c++)
+            set.set(static_cast<unsigned char>(c));
+        for (char c = 'A'; c <= 'Z'; c++)
+            set.set(static_cast<unsigned char>(c));
+        set.set('_');
+        return set;
+    case 's':
+        for (char c : std::string(" \t\n\r\f\v"))
+            set.set(static_cast<unsigned char>(c));
+        return set;
+    default:
+        return singleByte(ch);
+    }
+}
+
+} // namespace
+
+bool isGlobPattern(const std::string &name) {
+    return name.find_first_of("*?[") != std::string::npos;
+}
+
+// Thompson construction of one pattern into the matcher's NFA.
+struct PatternCompiler {
+    // A partially built automaton: its entry state and the edges still
+    // waiting for a target, as (state, 0 = out / 1 = out1).
+    struct Fragment {
+        int start;
+        std::vector<std::pair<int, int>> outs;
+    };
+
+    PatternCompiler(ModuleMatcher &matcher, const std::string &pattern, PatternSyntax syntax)
+        : matcher(matcher), pattern(pattern), syntax(syntax), end(pattern.size()) {}
+
+    // Compile the pattern and return its start state.
+    int compile(int index) {
+        Fragment body;
+        if (syntax == PatternSyntax::Glob) {
+            body = compileGlob();
+        } else {
+            bool anchoredStart = !pattern.empty() && pattern[0] == '^';
+            bool anchoredEnd = endsWithAnchor();
+            if (anchoredStart)
+                pos = 1;
+            if (anchoredEnd)
+                end--;
+
+            body = parseAlternation();
+            if (pos < end)
+                fail("unbalanced ')'");
+
+            if (!anchoredStart)
+                body = concat(star(bytes(anyByte())), std::move(body));
+            if (!anchoredEnd)
+                body = concat(std::move(body), star(bytes(anyByte())));
+        }
+
+        ModuleMatcher::NfaState match;
+        match.kind = ModuleMatcher::NfaState::Kind::Match;
+        match.pattern = index;
+        patch(body.outs, matcher.addState(match));
+        return body.start;
+    }
+
+  private:
+    [[noreturn]] void fail(const char *reason) const {
+        log_error("Invalid %s pattern '%s' at offset %zu: %s.\n",
+                  syntax == PatternSyntax::Glob ? "glob" : "regex", pattern.c_str(), pos, reason);
+    }
+
+    Fragment bytes(const ByteSet &set) {
+        ModuleMatcher::NfaState state;
+        state.kind = ModuleMatcher::NfaState::Kind::Byte;
+        state.bytes = set;
+        int s = matcher.addState(state);
+        return {s, {{s, 0}}};
+    }
+
+    int split(int out, int out1) {
+        ModuleMatcher::NfaState state;
+        state.kind = ModuleMatcher::NfaState::Kind::Split;
+        state.out = out;
+        state.out1 = out1;
+        return matcher.addState(state);
+    }
+
+    void patch(const std::vector<std::pair<int, int>> &outs, int target) {
+        for (auto [state, slot] : outs) {
+            (slot == 0 ? matcher.nfa[state].out : matcher.nfa[state].out1) = target;
+        }
+    }
+
+    Fragment empty() {
+        int s = split(-1, -1);
+        return {s, {{s, 0}}};
+    }
+
+    Fragment concat(Fragment a, Fragment b) {
+        patch(a.outs, b.start);
+        return {a.start, std::move(b.outs)};
+    }
+
+    Fragment alternate(Fragment a, Fragment b) {
+        int s = split(a.start, b.start);
+        a.outs.insert(a.outs.end(), b.outs.begin(), b.outs.end());
+        return {s, std::move(a.outs)};
+    }
+
+    Fragment star(Fragment a) {
+        int s = split(a.start, -1);
+        patch(a.outs, s);
+        return {s, {{s, 1}}};
+    }
+
+    Fragment plus(Fragment a) {
+        int s = split(a.start, -1);
+        patch(a.outs, s);
+        return {a.start, {{s, 1}}};
+    }
+
+    Fragment optional(Fragment a) {
+        int s = split(a.start, -1);
+        a.outs.push_back({s, 1});
+        return {s, std::move(a.outs)};
+    }
+
+    // A trailing `$` anchors the pattern unless it is escaped.
+    bool endsWithAnchor() const {
+        if (pattern.empty() || pattern.back() != '$')
+            return false;
+        size_t backslashes = 0;
+        for (size_t i = pattern.size() - 1; i > 0 && pattern[i - 1] == '\\'; i--)
+            backslashes++;
+        return backslashes % 2 == 0;
+    }
+
+    Fragment compileGlob() {
+        Fragment result = empty();
+        while (pos < end) {
+            char ch = pattern[pos++];
+            if (ch == '*')
+                result = concat(std::move(result), star(bytes(anyByte())));
+            else if (ch == '?')
+                result = concat(std::move(result), bytes(anyByte()));
+            else if (ch == '[')
+                result = concat(std::move(result), bytes(parseClass()));
+            else
+                result = concat(std::move(result), bytes(singleByte(ch)));
+        }
+        return result;
+    }
+
+    // `[...]` with ranges; `]` right after the opening bracket is literal.
+    // Negated by a leading `^` (or `!` in globs).
+    ByteSet parseClass() {
+        ByteSet set;
+        bool negate = false;
+        bool globNegation = syntax == PatternSyntax::Glob && pattern[pos] == '!';
+        if (pos < end && (pattern[pos] == '^' || globNegation)) {
+            negate = true;
+            pos++;
+        }
+
+        for (bool first = true;; first = false) {
+            if (pos >= end)
+                fail("unterminated character class");
+            if (pattern[pos] == ']' && !first) {
+                pos++;
+                break;
+            }
+
+            unsigned char lo = classChar();
+            if (pos + 1 < end && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+                pos++;
+                unsigned char hi = classChar();
+                if (hi < lo)
+                    fail("reversed range in character class");
+                for (unsigned c = lo; c <= hi; c++)
+                    set.set(c);
+            } else {
+                set.set(lo);
+            }
+        }
+
+        return negate ? ~set : set;
+    }
+
+    unsigned char classChar() {
+        if (syntax == PatternSyntax::Regex && pattern[pos] == '\\') {
+            pos++;
+            if (pos >= end)
+                fail("trailing backslash");
+        }
+        return static_cast<unsigned char>(pattern[pos++]);
+    }
+
+    Fragment parseAlternation() {
+        Fragment result = parseConcatenation();
+        while (pos < end && pattern[pos] == '|') {
+            pos++;
+            result = alternate(std::move(result), parseConcatenation());
+        }
+        return result;
+    }
+
+    Fragment parseConcatenation() {
+        Fragment result = empty();
+        while (pos < end && pattern[pos] != '|' && pattern[pos] != ')') {
+            result = concat(std::move(result), parseRepeat());
+        }
+        return result;
+    }
+
+    Fragment parseRepeat() {
+        Fragment atom = parseAtom();
+        while (pos < end && (pattern[pos] == '*' || pattern[pos] == '+' || pattern[pos] == '?')) {
+            char op = pattern[pos++];
+            if (op == '*')
+                atom = star(std::move(atom));
+            else if (op == '+')
+                atom = plus(std::move(atom));
+            else
+                atom = optional(std::move(atom));
+        }
+        return atom;
+    }
+
+    Fragment parseAtom() {
+        char ch = pattern[pos];
+        switch (ch) {
+        case '*':
+        case '+':
+        case '?':
+            fail("repetition without an operand");
+        case '^':
+        case '$':
+            fail("anchors are only supported at the start and end of a pattern");
+        default:
+            break;
+        }
+        pos++;
+
+        switch (ch) {
+        case '(': {
+            Fragment inner = parseAlternation();
+            if (pos >= end || pattern[pos] != ')')
+                fail("missing ')'");
+            pos++;
+            return inner;
+        }
+        case '.':
+            return bytes(anyByte());
+        case '[':
+            return bytes(parseClass());
+        case '\\':
+            if (pos >= end)
+                fail("trailing backslash");
+            return bytes(escapedBytes(pattern[pos++]));
+        default:
+            return bytes(singleByte(ch));
+        }
+    }
+
+    ModuleMatcher &matcher;
+    const std::string &pattern;
+    PatternSyntax syntax;
+    size_t pos = 0;
+    size_t end;
+};
+
+int ModuleMatcher::addState(NfaState state) {
+    nfa.push_back(state);
+    return static_cast<int>(nfa.size() - 1);
+}
+
+int ModuleMatcher::addPattern(const std::string &pattern, PatternSyntax syntax) {
+    int index = static_cast<int>(patternCount);
+    PatternCompiler compiler(*this, pattern, syntax);
+    starts.push_back(compiler.compile(index));
+    patternCount++;
+
+    // The cached DFA was built without this pattern.
+    dfa.clear();
+    dfaIds.clear();
+    return index;
+}
+
+// The DFA state for the epsilon closure of `nfaStates`, created on first use.
+int ModuleMatcher::dfaState(std::vector<int> nfaStates) const {
+    std::vector<int> closure;
+    std::vector<bool> seen(nfa.size(), false);
+
+    while (!nfaStates.empty()) {
+        int s = nfaStates.back();
+        nfaStates.pop_back();
+        if (s < 0 || seen[s])
+            continue;
+        seen[s] = true;
+
+        if (nfa[s].kind == NfaState::Kind::Split) {
+            nfaStates.push_back(nfa[s].out);
+            nfaStates.push_back(nfa[s].out1);
+        } else {
+            closure.push_back(s);
+        }
+    }
+    std::sort(closure.begin(), closure.end());
+
+    auto known = dfaIds.find(closure);
+    if (known != dfaIds.end())
+        return known->second;
+
+    DfaState state;
+    for (int s : closure) {
+        if (nfa[s].kind == NfaState::Kind::Match)
+            state.matches.push_back(nfa[s].pattern);
+    }
+    std::sort(state.matches.begin(), state.matches.end());
+    state.next.assign(256, -1);
+    state.nfaStates = closure;
+
+    int id = static_cast<int>(dfa.size());
+    dfa.push_back(std::move(state));
+    dfaIds[std::move(closure)] = id;
+    return id;
+}
+
+int ModuleMatcher::step(int state, unsigned char byte) const {
+    int cached = dfa[state].next[byte];
+    if (cached >= 0)
+        return cached;
+
+    std::vector<int> targets;
+    for (int s : dfa[state].nfaStates) {
+        if (nfa[s].kind == NfaState::Kind::Byte && nfa[s].bytes.test(byte))
+            targets.push_back(nfa[s].out);
+    }
+
+    int next = dfaState(std::move(targets));
+    dfa[state].next[byte] = next;
+    return next;
+}
+
+std::vector<int> ModuleMatcher::match(const std::string &name) const {
+    if (dfa.empty())
+        dfaState(starts);
+
+    // State 0 is the closure of all pattern start states.
+    int state = 0;
+    for (char ch : name) {
+        state = step(state, static_cast<unsigned char>(ch));
+        if (dfa[state].nfaStates.empty())
+            break;
+    }
+    return dfa[state].matches;
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -4,42 +4,442 @@
 #include "kernel/yosys.h"
 #include "kernel/yosys_common.h"
 #include "tmrx.h"
+#include "tmrx_design_index.h"
 #include "tmrx_logic_expansion.h"
 #include "tmrx_mod_expansion.h"
+#include "tmrx_module_cache.h"
+#include "tmrx_stats.h"
+#include "tmrx_trace.h"
 #include "tmrx_utils.h"
 #include "utils.h"
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <sys/wait.h>
 #include <tuple>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// Group the topologically sorted modules into hierarchy levels: level 0 holds
+// the leaves and every other module sits one level above its deepest child.
+// Modules within a level never instantiate each other, so their expansions
+// are independent; each level is ordered by name so the result does not
+// depend on the order in which modules were added to the design.
+std::vector<std::vector<RTLIL::IdString>>
+groupIntoLevels(const std::vector<RTLIL::IdString> &leafFirst,
+                const dict<RTLIL::IdString, pool<RTLIL::IdString>> &children) {
+    dict<RTLIL::IdString, size_t> levelOf;
+    std::vector<std::vector<RTLIL::IdString>> levels;
+
+    for (auto &name : leafFirst) {
+        if (children.count(name) == 0) {
+            continue;
+        }
+
+        size_t level = 0;
+        for (auto &child : children.at(name)) {
+            if (levelOf.count(child) != 0) {
+                level = std::max(level, levelOf.at(child) + 1);
+            }
+        }
+
+        levelOf[name] = level;
+        if (levels.size() <= level) {
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(name);
+    }
+
+    for (auto &level : levels) {
+        level = TMRX::sortedNames(level);
+    }
+
+    return levels;
+}
+
+// A module of a hierarchy level that is expanded, with its config and, with
+// -incremental, its module cache key.
+struct ModuleJob {
+    RTLIL::IdString name;
+    const TMRX::Config *cfg = nullptr;
+    std::string cacheKey;
+};
+
 struct TmrxPass : public Pass {
   private:
+    // Fill in `job` for `moduleName`. Returns false if the module is not
+    // expanded.
+    bool prepareModule(RTLIL::Design *design, TMRX::ConfigManager &cfgMgr,
+                       TMRX::ModuleCache *moduleCache, RTLIL::IdString moduleName,
+                       ModuleJob &job) {
+        RTLIL::Module *worker = design->module(moduleName);
+        if (!worker)
+            return false;
+
+        // Blackbox modules (standard cells, IP blackboxes) that appear as
+        // edge-only nodes in the topo sort must not be expanded. They were
+        // intentionally excluded from the node-building loop in execute().
+        if (worker->get_blackbox_attribute())
+            return false;
+
+        job.name = moduleName;
+        job.cfg = cfgMgr.getConfig(worker);
+
+        // Parents' cache keys include this module's key, so it is taken
+        // before expansion and for None-mode modules as well.
+        if (moduleCache != nullptr) {
+            job.cacheKey = moduleCache->moduleKey(worker, job.cfg);
+        }
+
+        return job.cfg->tmrMode != TMRX::TmrMode::None;
+    }
+
+    void expandModule(RTLIL::Design *design, TMRX::ConfigManager &cfgMgr,
+                      TMRX::DesignIndex &index, TMRX::ModuleCache *moduleCache,
+                      const ModuleJob &job) {
+        RTLIL::IdString moduleName = job.name;
+        RTLIL::Module *worker = design->module(moduleName);
+        const TMRX::Config *cfg = job.cfg;
+        const std::string &cacheKey = job.cacheKey;
+
+        log("Processing module '%s' [%s]\n", moduleName.c_str(),
+            TMRX::tmrModeToString(cfg->tmrMode).c_str());
+        TMRX::TraceSpan moduleSpan("module", log_id(moduleName),
+                                   TMRX::tmrModeToString(cfg->tmrMode));
+        TMRX::StatsModule moduleStats(moduleName, TMRX::tmrModeToString(cfg->tmrMode));
+
+        if (moduleCache != nullptr) {
+            if (moduleCache->restore(moduleName, cacheKey, index)) {
+                return;
+            }
+            moduleCache->beginExpansion();
+        }
+
+        // When preserve_module_ports=false and this is a proper submodule,
+        // clone the module before expansion. The clone is what gets expanded
+        // (triplicated ports etc.) while the original keeps its interface
+        // unchanged so that FullModuleTMR parents can connect to it without
+        // port mismatches. LogicTMR parents remap cell types to the clone
+        // via the tmrx_impl_module attribute.
+        RTLIL::Module *target = worker;
+        if (!cfg->preserveModulePorts && TMRX::isProperSubmodule(worker)) {
+            RTLIL::IdString implName =
+                RTLIL::IdString(worker->name.str() + TMRX::tmrx_impl_module_suffix);
+            target = design->addModule(implName);
+            worker->cloneInto(target);
+            target->name = implName;
+            index.addModule(target);
+            target->set_bool_attribute(TMRX::ATTRIBUTE_IS_PROPER_SUBMODULE, true);
+            worker->set_string_attribute(TMRX::ATTRIBUTE_IMPL_MODULE, implName.str());
+            log("  Cloned '%s' -> '%s' for port-preserving expansion\n", worker->name.c_str(),
+                implName.c_str());
+        }
+
+        // Expansion rewrites the interface of `target`; drop its cached
+        // ports so parents expanded later see the triplicated ones.
+        RTLIL::IdString targetName = target->name;
+
+        if (cfg->tmrMode == TMRX::TmrMode::LogicTMR) {
+            TMRX::logicTmrExpansion(target, &cfgMgr, &index, cfg);
+            target->fixup_ports();
+        }
+
+        if (cfg->tmrMode == TMRX::TmrMode::FullModuleTMR) {
+            // fullModuleTmrExpansion removes `target` (the _tmrx_worker
+            // template) from the design at the end, so `target` is a
+            // dangling pointer after the call. The wrapper module created
+            // inside already calls fixup_ports() before that point.
+            TMRX::fullModuleTmrExpansion(target, &cfgMgr, &index, cfg);
+        }
+
+        index.invalidatePorts(targetName);
+
+        if (moduleCache != nullptr) {
+            moduleCache->store(moduleName, cacheKey);
+        }
+    }
+
+    // Expand the modules of one hierarchy level. With -j, they are expanded
+    // in worker processes if the level has more than one.
+    void expandLevel(RTLIL::Design *design, TMRX::ConfigManager &cfgMgr,
+                     TMRX::DesignIndex &index, TMRX::ModuleCache *moduleCache,
+                     TMRX::ModuleCache *levelEntries, const std::string &workDir,
+                     const std::vector<ModuleJob> &jobs, size_t processes) {
+        TMRX::beginLevelIds();
+        if (levelEntries == nullptr || jobs.size() < 2 ||
+            !expandInWorkers(design, cfgMgr, index, moduleCache, *levelEntries, workDir, jobs,
+                             processes)) {
+            for (auto &job : jobs) {
+                TMRX::beginModuleIds();
+                expandModule(design, cfgMgr, index, moduleCache, job);
+                TMRX::endModuleIds(autoidx);
+            }
+        }
+        TMRX::endLevelIds();
+    }
+
+    // RTLIL is not thread-safe (IdStrings, autoidx, the log), so each worker
+    // is a forked process expanding every `processes`-th job on its own copy
+    // of the design. It stores each expansion in `levelEntries` together
+    // with its log and last NEW_ID number; the expansions are then applied
+    // to this design in name order, which yields the netlist of expanding
+    // the jobs one after the other. Returns false, with the design untouched,
+    // if a worker could not be started or failed; expanding the level in
+    // this process then reports the error.
+    bool expandInWorkers(RTLIL::Design *design, TMRX::ConfigManager &cfgMgr,
+                         TMRX::DesignIndex &index, TMRX::ModuleCache *moduleCache,
+                         TMRX::ModuleCache &levelEntries, const std::string &workDir,
+                         const std::vector<ModuleJob> &jobs, size_t processes) {
+        processes = std::min(processes, jobs.size());
+        log("  Expanding %zu module(s) in %zu worker process(es)\n", jobs.size(), processes);
+
+        // Output still buffered at the fork would be written by every worker.
+        log_flush();
+
+        std::vector<pid_t> pids;
+        for (size_t process = 0; process < processes; process++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                runWorker(design, cfgMgr, index, moduleCache, levelEntries, workDir, jobs, process,
+                          processes);
+            }
+            if (pid < 0) {
+                log_warning("Can't start expansion worker: %s\n", strerror(errno));
+                break;
+            }
+            pids.push_back(pid);
+        }
+
+        bool succeeded = pids.size() == processes;
+        for (auto pid : pids) {
+            int status = 0;
+            if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+                WEXITSTATUS(status) != 0) {
+                succeeded = false;
+            }
+        }
+        if (!succeeded) {
+            log("  Expansion worker failed; expanding the level in this process\n");
+            return false;
+        }
+
+        for (size_t job = 0; job < jobs.size(); job++) {
+            std::string key = stringf("job%zu", job);
+
+            std::ifstream logIn(workDir + "/" + key + ".log");
+            std::stringstream workerLog;
+            workerLog << logIn.rdbuf();
+            log("%s", workerLog.str().c_str());
+
+            std::ifstream resultIn(workDir + "/" + key + ".result");
+            int lastId = 0;
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t added = 0;
+            if (!(resultIn >> lastId >> hits >> misses) ||
+                !levelEntries.apply(jobs[job].name, key, index, added)) {
+                log_error("Can't merge the expansion of module '%s' from '%s'.\n",
+                          log_id(jobs[job].name), workDir.c_str());
+            }
+
+            TMRX::endModuleIds(lastId);
+            if (moduleCache != nullptr) {
+                moduleCache->hits += hits;
+                moduleCache->misses += misses;
+            }
+        }
+        return true;
+    }
+
+    [[noreturn]] void runWorker(RTLIL::Design *design, TMRX::ConfigManager &cfgMgr,
+                                TMRX::DesignIndex &index, TMRX::ModuleCache *moduleCache,
+                                TMRX::ModuleCache &levelEntries, const std::string &workDir,
+                                const std::vector<ModuleJob> &jobs, size_t process,
+                                size_t processes) {
+        bool succeeded = true;
+        try {
+            // Each expansion logs to its own file, which the merge replays.
+            log_streams.clear();
+            log_errfile = nullptr;
+
+            for (size_t job = process; succeeded && job < jobs.size(); job += processes) {
+                std::string key = stringf("job%zu", job);
+                FILE *logFile = fopen((workDir + "/" + key + ".log").c_str(), "w");
+                if (logFile == nullptr) {
+                    succeeded = false;
+                    break;
+                }
+                log_files = {logFile};
+
+                size_t hits = moduleCache != nullptr ? moduleCache->hits : 0;
+                size_t misses = moduleCache != nullptr ? moduleCache->misses : 0;
+
+                levelEntries.beginExpansion();
+                TMRX::beginModuleIds();
+                expandModule(design, cfgMgr, index, moduleCache, jobs[job]);
+                TMRX::endModuleIds(autoidx);
+                levelEntries.store(jobs[job].name, key);
+
+                log_files.clear();
+                fclose(logFile);
+
+                if (moduleCache != nullptr) {
+                    hits = moduleCache->hits - hits;
+                    misses = moduleCache->misses - misses;
+                }
+                succeeded = TMRX::writeFileAtomically(
+                    workDir + "/" + key + ".result",
+                    stringf("%d %zu %zu\n", TMRX::endLevelIds(), hits, misses));
+            }
+        } catch (...) {
+            succeeded = false;
+        }
+
+        // Skip exit handlers and destructors; they belong to the parent.
+        _exit(succeeded ? 0 : 1);
+    }
+
   public:
     TmrxPass() : Pass("tmrx", "add triple modular redundancy") {}
 
+    void help() override {
+        log("\n");
+        log("    tmrx [options] [selection]\n");
+        log("\n");
+        log("Apply triple modular redundancy to the selected modules.\n");
+        log("\n");
+        log("    -c <file>\n");
+        log("        TOML configuration file. Defaults are used if omitted.\n");
+        log("\n");
+        log("    -config-cache <dir>\n");
+        log("        Cache the resolved module configurations in <dir>. A later run with\n");
+        log("        the same config file, module TMRX attributes and plugin build loads\n");
+        log("        them from there instead of parsing and resolving the config again.\n");
+        log("\n");
+        log("    -incremental <dir>\n");
+        log("        Cache every expanded module in <dir>, keyed by a hash of its RTLIL,\n");
+        log("        its configuration and the keys of its submodules. Modules whose key\n");
+        log("        is found are restored from the cache instead of expanded again.\n");
+        log("\n");
+        log("    -trace <file.json>\n");
+        log("        Write a Chrome trace-event profile of this run (module expansions,\n");
+        log("        expansion phases, voter batches, configuration loading and cleanup)\n");
+        log("        that can be opened in Perfetto or chrome://tracing.\n");
+        log("\n");
+        log("    -stats <file.json>\n");
+        log("        Write per-module and per-phase wall time, created cells, wires and\n");
+        log("        voters, and peak memory growth of this run to a JSON file.\n");
+        log("\n");
+        log("    -j <N>\n");
+        log("        Expand the modules of each hierarchy level in up to N worker\n");
+        log("        processes (default 1). The result does not depend on N. Ignored\n");
+        log("        with -stats and -trace, which measure expansion in this process.\n");
+        log("\n");
+    }
+
     void execute(std::vector<std::string> args, RTLIL::Design *design) override {
         log_header(design, "Executing TMRX pass (Triple Modular Redundancy).\n");
         log_push();
 
         std::string configFile = "";
+        std::string configCacheDir;
+        std::string incrementalDir;
+        std::string statsFile;
+        std::string traceFile;
+        size_t processes = 1;
 
         for (size_t arg = 1; arg < args.size(); arg++) {
             if (args[arg] == "-c" && arg + 1 < args.size()) {
                 configFile = args[++arg];
                 continue;
             }
+            if (args[arg] == "-config-cache" && arg + 1 < args.size()) {
+                configCacheDir = args[++arg];
+                continue;
+            }
+            if (args[arg] == "-incremental" && arg + 1 < args.size()) {
+                incrementalDir = args[++arg];
+                continue;
+            }
+            if (args[arg] == "-trace" && arg + 1 < args.size()) {
+                traceFile = args[++arg];
+                continue;
+            }
+            if (args[arg] == "-stats" && arg + 1 < args.size()) {
+                statsFile = args[++arg];
+                continue;
+            }
+            if (args[arg] == "-j" && arg + 1 < args.size()) {
+                int value = atoi(args[++arg].c_str());
+                if (value < 1) {
+                    log_cmd_error("Invalid number of worker processes '%s'.\n",
+                                  args[arg].c_str());
+                }
+                processes = value;
+                continue;
+            }
             break;
         }
 
-        TMRX::ConfigManager cfgMgr(design, configFile);
+        std::unique_ptr<TMRX::TraceRecorder> trace;
+        if (!traceFile.empty()) {
+            trace.reset(new TMRX::TraceRecorder());
+        }
+        TMRX::TraceSpan passSpan("pass", "tmrx", configFile);
+
+        std::unique_ptr<TMRX::StatsRecorder> stats;
+        if (!statsFile.empty()) {
+            stats.reset(new TMRX::StatsRecorder(design));
+        }
+
+        TMRX::ConfigManager cfgMgr(design, configFile, configCacheDir);
+
+        // Resolve the configs of the modules that can be expanded up front:
+        // loading their custom voters runs passes on the design, which must
+        // happen before it is indexed. Other modules are resolved if queried.
+        std::vector<RTLIL::Module *> selectedModules;
+        for (auto module : design->modules()) {
+            if (design->selected(module) && !module->get_blackbox_attribute()) {
+                selectedModules.push_back(module);
+            }
+        }
+        cfgMgr.resolveConfigs(selectedModules);
+
+        TMRX::DesignIndex index(design);
+        TMRX::resolveMarkedFlipFlops(design);
+
+        std::unique_ptr<TMRX::ModuleCache> moduleCache;
+        if (!incrementalDir.empty()) {
+            moduleCache.reset(new TMRX::ModuleCache(design, incrementalDir));
+        }
+
+        // Worker processes hand their expansions over as module cache
+        // entries in a temporary directory.
+        if (processes > 1 && (stats || trace)) {
+            log_warning("Ignoring -j %zu: -stats and -trace measure expansion in this process.\n",
+                        processes);
+            processes = 1;
+        }
+        std::unique_ptr<TMRX::ModuleCache> levelEntries;
+        std::string workDir;
+        if (processes > 1) {
+            workDir = make_temp_dir(get_base_tmpdir() + "/tmrx_XXXXXX");
+            levelEntries.reset(new TMRX::ModuleCache(design, workDir));
+        }
 
         TopoSort<RTLIL::IdString> modulesToProcess;
+        dict<RTLIL::IdString, pool<RTLIL::IdString>> children;
 
         for (auto module : design->modules()) {
             if (!design->selected(module) || module->get_blackbox_attribute()) {
@@ -47,69 +447,43 @@ struct TmrxPass : public Pass {
             }
 
             modulesToProcess.node(module->name);
+            children[module->name];
 
             for (auto c : module->cells()) {
                 if (design->module(c->type) && (TMRX::isProperSubmodule(design->module(c->type)))) {
                     modulesToProcess.edge(module->name, c->type);
+                    children[module->name].insert(c->type);
                 }
             }
         }
 
         modulesToProcess.sort();
 
-        for (auto it = modulesToProcess.sorted.rbegin(); it != modulesToProcess.sorted.rend();
-             ++it) {
-            RTLIL::IdString moduleName = *it;
-            RTLIL::Module *worker = design->module(moduleName);
-            if (!worker)
-                continue;
-
-            // Blackbox modules (standard cells, IP blackboxes) that appear as
-            // edge-only nodes in the topo sort must not be expanded. They were
-            // intentionally excluded from the node-building loop above.
-            if (worker->get_blackbox_attribute())
-                continue;
-
-            const TMRX::Config *cfg = cfgMgr.getConfig(worker);
-
-            if (cfg->tmrMode == TMRX::TmrMode::None) {
-                continue;
-            }
+        std::vector<RTLIL::IdString> leafFirst(modulesToProcess.sorted.rbegin(),
+                                               modulesToProcess.sorted.rend());
+        auto levels = groupIntoLevels(leafFirst, children);
 
-            log("Processing module '%s' [%s]\n", moduleName.c_str(),
-                TMRX::tmrModeToString(cfg->tmrMode).c_str());
-
-            // When preserve_module_ports=false and this is a proper submodule,
-            // clone the module before expansion. The clone is what gets expanded
-            // (triplicated ports etc.) while the original keeps its interface
-            // unchanged so that FullModuleTMR parents can connect to it without
-            // port mismatches. LogicTMR parents remap cell types to the clone
-            // via the tmrx_impl_module attribute.
-            RTLIL::Module *target = worker;
-            if (!cfg->preserveModulePorts && TMRX::isProperSubmodule(worker)) {
-                RTLIL::IdString implName =
-                    RTLIL::IdString(worker->name.str() + TMRX::tmrx_impl_module_suffix);
-                target = design->addModule(implName);
-                worker->cloneInto(target);
-                target->name = implName;
-                target->set_bool_attribute(TMRX::ATTRIBUTE_IS_PROPER_SUBMODULE, true);
-                worker->set_string_attribute(TMRX::ATTRIBUTE_IMPL_MODULE, implName.str());
-                log("  Cloned '%s' -> '%s' for port-preserving expansion\n", worker->name.c_str(),
-                    implName.c_str());
+        for (size_t level = 0; level < levels.size(); level++) {
+            log("Expanding hierarchy level %zu (%zu module(s))\n", level, levels[level].size());
+            TMRX::TraceSpan levelSpan("pass", stringf("level %zu", level));
+            std::vector<ModuleJob> jobs;
+            for (auto &moduleName : levels[level]) {
+                ModuleJob job;
+                if (prepareModule(design, cfgMgr, moduleCache.get(), moduleName, job)) {
+                    jobs.push_back(job);
+                }
             }
+            expandLevel(design, cfgMgr, index, moduleCache.get(), levelEntries.get(), workDir, jobs,
+                        processes);
+        }
 
-            if (cfg->tmrMode == TMRX::TmrMode::LogicTMR) {
-                TMRX::logicTmrExpansion(target, &cfgMgr, cfg);
-                target->fixup_ports();
-            }
+        if (levelEntries) {
+            remove_directory(workDir);
+        }
 
-            if (cfg->tmrMode == TMRX::TmrMode::FullModuleTMR) {
-                // fullModuleTmrExpansion removes `target` (the _tmrx_worker
-                // template) from the design at the end, so `target` is a
-                // dangling pointer after the call. The wrapper module created
-                // inside already calls fixup_ports() before that point.
-                TMRX::fullModuleTmrExpansion(target, &cfgMgr, cfg);
-            }
+        if (moduleCache) {
+            log("Module cache: %zu module(s) restored, %zu expanded\n", moduleCache->hits,
+                moduleCache->misses);
         }
 
         // Remove original modules that were cloned to _tmrx_impl, but only if
@@ -121,33 +495,39 @@ struct TmrxPass : public Pass {
         // references are safe to delete (keeping them would cause the stat
         // crash described above, because stat only builds mod_stat for modules
         // reachable from the top).
-        std::vector<RTLIL::IdString> toRemove;
-        for (auto module : design->modules()) {
-            if (module->has_attribute(TMRX::ATTRIBUTE_IMPL_MODULE)) {
-                toRemove.push_back(module->name);
-            }
-        }
-        for (auto name : toRemove) {
-            bool stillReferenced = false;
-            for (auto mod : design->modules()) {
-                for (auto cell : mod->cells()) {
-                    if (cell->type == name) {
-                        stillReferenced = true;
-                        break;
-                    }
+        //
+        // References are looked up in the design index instead of scanning
+        // every cell per candidate. Candidates are visited top-down, so an
+        // original that is only instantiated by another removed original is
+        // released before it is checked.
+        TMRX::TraceSpan cleanupSpan("pass", "cleanup");
+        for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+            for (auto &name : *level) {
+                RTLIL::Module *module = design->module(name);
+                if (module == nullptr || !module->has_attribute(TMRX::ATTRIBUTE_IMPL_MODULE)) {
+                    continue;
+                }
+                if (index.instanceCount(name) != 0) {
+                    log("Keeping original module '%s' (still referenced by None-mode parent)\n",
+                        name.c_str());
+                } else {
+                    log("Removing original module '%s' (replaced by _tmrx_impl clone)\n",
+                        name.c_str());
+                    index.removeModule(module);
                 }
-                if (stillReferenced)
-                    break;
-            }
-            if (stillReferenced) {
-                log("Keeping original module '%s' (still referenced by None-mode parent)\n",
-                    name.c_str());
-            } else {
-                log("Removing original module '%s' (replaced by _tmrx_impl clone)\n", name.c_str());
-                design->remove(design->module(name));
             }
         }
 
+        cleanupSpan.end();
+
+        if (stats) {
+            stats->writeJson(statsFile);
+        }
+        if (trace) {
+            passSpan.end();
+            trace->writeJson(traceFile);
+        }
+
         log_pop();
     }
 } TmrxPass;
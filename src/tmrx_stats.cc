@@ -0,0 +1,193 @@
+#include "tmrx_stats.h"
+#include "kernel/rtlil.h"
+#include "kernel/yosys.h"
+#include "utils.h"
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+namespace {
+
+StatsRecorder *activeRecorder = nullptr;
+
+long peakRssKb() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+void writeSpan(std::ostream &f, const SpanStats &span) {
+    f << stringf("\"seconds\": %.6f, \"cells_created\": %ld, \"wires_created\": %ld, "
+                 "\"voters_created\": %ld, \"peak_rss_delta_kb\": %ld",
+                 span.seconds, span.cells, span.wires, span.voters, span.peakRssKb);
+}
+
+void addPhase(std::vector<std::pair<std::string, SpanStats>> &phases, const std::string &name,
+              const SpanStats &span) {
+    for (auto &phase : phases) {
+        if (phase.first == name) {
+            phase.second.add(span);
+            return;
+        }
+    }
+    phases.emplace_back(name, span);
+}
+
+} // namespace
+
+void SpanStats::add(const SpanStats &other) {
+    seconds += other.seconds;
+    cells += other.cells;
+    wires += other.wires;
+    voters += other.voters;
+    peakRssKb += other.peakRssKb;
+}
+
+StatsRecorder::StatsRecorder(RTLIL::Design *design) : design(design) {
+    runStart = sample();
+    activeRecorder = this;
+}
+
+StatsRecorder::~StatsRecorder() {
+    if (activeRecorder == this) {
+        activeRecorder = nullptr;
+    }
+}
+
+StatsRecorder *StatsRecorder::active() { return activeRecorder; }
+
+StatsRecorder::Sample StatsRecorder::sample() const {
+    Sample s;
+    s.time = std::chrono::steady_clock::now();
+    s.cells = 0;
+    s.wires = 0;
+    for (auto module : design->modules()) {
+        s.cells += GetSize(module->cells());
+        s.wires += GetSize(module->wires());
+    }
+    s.voters = voters;
+    s.peakRssKb = peakRssKb();
+    return s;
+}
+
+SpanStats StatsRecorder::since(const Sample &start) const {
+    Sample now = sample();
+    SpanStats span;
+    span.seconds = std::chrono::duration<double>(now.time - start.time).count();
+    span.cells = now.cells - start.cells;
+    span.wires = now.wires - start.wires;
+    span.voters = now.voters - start.voters;
+    span.peakRssKb = now.peakRssKb - start.peakRssKb;
+    return span;
+}
+
+void StatsRecorder::writeJson(const std::string &path) {
+    SpanStats total = since(runStart);
+    Sample end = sample();
+    std::vector<std::pair<std::string, SpanStats>> phaseTotals;
+    for (auto &module : modules) {
+        for (auto &phase : module.phases) {
+            addPhase(phaseTotals, phase.first, phase.second);
+        }
+    }
+
+    std::ofstream f(path);
+    if (f.fail()) {
+        log_error("Can't open stats file '%s' for writing.\n", path.c_str());
+    }
+
+    f << "{\n  \"modules\": [";
+    for (size_t i = 0; i < modules.size(); i++) {
+        const ModuleStats &module = modules[i];
+        f << (i == 0 ? "\n" : ",\n");
+        f << "    {\"name\": \"" << jsonEscape(module.name) << "\", \"mode\": \""
+          << jsonEscape(module.mode) << "\", ";
+        writeSpan(f, module.total);
+        f << ", \"phases\": [";
+        for (size_t j = 0; j < module.phases.size(); j++) {
+            f << (j == 0 ? "\n" : ",\n");
+            f << "      {\"name\": \"" << module.phases[j].first << "\", ";
+            writeSpan(f, module.phases[j].second);
+            f << "}";
+        }
+        f << (module.phases.empty() ? "]}" : "\n    ]}");
+    }
+    f << (modules.empty() ? "],\n" : "\n  ],\n");
+
+    f << "  \"phases\": [";
+    for (size_t i = 0; i < phaseTotals.size(); i++) {
+        f << (i == 0 ? "\n" : ",\n");
+        f << "    {\"name\": \"" << phaseTotals[i].first << "\", ";
+        writeSpan(f, phaseTotals[i].second);
+        f << "}";
+    }
+    f << (phaseTotals.empty() ? "],\n" : "\n  ],\n");
+
+    f << "  \"totals\": {\"modules\": " << modules.size() << ", ";
+    writeSpan(f, total);
+    f << ", \"design_cells\": " << end.cells << ", \"design_wires\": " << end.wires
+      << ", \"peak_rss_kb\": " << end.peakRssKb << "}\n}\n";
+
+    log("Wrote TMRX statistics for %zu module(s) to '%s'\n", modules.size(), path.c_str());
+}
+
+StatsModule::StatsModule(RTLIL::IdString name, const std::string &mode)
+    : recorder(StatsRecorder::active()) {
+    if (recorder == nullptr) {
+        return;
+    }
+    recorder->modules.push_back({log_id(name), mode, {}, {}});
+    recorder->current = &recorder->modules.back();
+    start = recorder->sample();
+}
+
+StatsModule::~StatsModule() {
+    if (recorder == nullptr || recorder->current == nullptr) {
+        return;
+    }
+    recorder->current->total = recorder->since(start);
+    recorder->current = nullptr;
+}
+
+StatsPhase::StatsPhase(const char *name)
+    : recorder(StatsRecorder::active()), name(name), span("phase", name) {
+    if (recorder == nullptr || recorder->current == nullptr) {
+        recorder = nullptr;
+        return;
+    }
+    start = recorder->sample();
+}
+
+StatsPhase::~StatsPhase() { end(); }
+
+void StatsPhase::end() {
+    span.end();
+    if (recorder == nullptr || recorder->current == nullptr) {
+        return;
+    }
+    addPhase(recorder->current->phases, name, recorder->since(start));
+    recorder = nullptr;
+}
+
+void countVoters(size_t count) {
+    if (activeRecorder != nullptr) {
+        activeRecorder->voters += count;
+    }
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -0,0 +1,353 @@
+#include "tmrx_timing.h"
+#include "kernel/log.h"
+#include "kernel/rtlil.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+namespace {
+
+// Split liberty source into quoted strings (quotes kept), punctuation and bare
+// words. Comments and line continuations are dropped.
+std::vector<std::string> tokenizeLiberty(const std::string &text) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    size_t n = text.size();
+
+    while (i < n) {
+        char ch = text[i];
+        if (std::isspace(static_cast<unsigned char>(ch)) || ch == '\\') {
+            i++;
+            continue;
+        }
+        if (ch == '/' && i + 1 < n && text[i + 1] == '*') {
+            size_t end = text.find("*/", i + 2);
+            i = end == std::string::npos ? n : end + 2;
+            continue;
+        }
+        if (ch == '/' && i + 1 < n && text[i + 1] == '/') {
+            size_t end = text.find('\n', i);
+            i = end == std::string::npos ? n : end;
+            continue;
+        }
+        if (ch == '"') {
+            size_t end = text.find('"', i + 1);
+            if (end == std::string::npos) {
+                end = n - 1;
+            }
+            tokens.push_back(text.substr(i, end - i + 1));
+            i = end + 1;
+            continue;
+        }
+        if (std::strchr("(){}:;,", ch) != nullptr) {
+            tokens.push_back(std::string(1, ch));
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < n && !std::isspace(static_cast<unsigned char>(text[i])) &&
+               std::strchr("(){}:;,\"", text[i]) == nullptr) {
+            i++;
+        }
+        tokens.push_back(text.substr(start, i - start));
+    }
+
+    return tokens;
+}
+
+std::string unquote(const std::string &token) {
+    if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
+        return token.substr(1, token.size() - 2);
+    }
+    return token;
+}
+
+// First number of a liberty value such as "0.12, 0.15, 0.21".
+std::optional<double> firstNumber(const std::string &token) {
+    std::string value = unquote(token);
+    const char *begin = value.c_str();
+    while (*begin != '\0' && std::isspace(static_cast<unsigned char>(*begin))) {
+        begin++;
+    }
+    char *end = nullptr;
+    double number = std::strtod(begin, &end);
+    if (end == begin) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+bool isDelayTable(const std::vector<std::string> &groups) {
+    return !groups.empty() && (groups.back() == "cell_rise" || groups.back() == "cell_fall");
+}
+
+} // namespace
+
+TimingLibrary readTimingLibrary(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        log_error("Cannot open liberty file '%s'.\n", path.c_str());
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::vector<std::string> tokens = tokenizeLiberty(buffer.str());
+
+    TimingLibrary library;
+    std::vector<std::string> groups;
+    std::string cellName;
+
+    auto record = [&](std::optional<double> delay) {
+        if (!delay || cellName.empty()) {
+            return;
+        }
+        double &cellDelay = library.cellDelays[makeRtlilId(cellName)];
+        cellDelay = std::max(cellDelay, *delay);
+    };
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const std::string &token = tokens[i];
+
+        if (token == "}") {
+            if (!groups.empty()) {
+                if (groups.back() == "cell") {
+                    cellName.clear();
+                }
+                groups.pop_back();
+            }
+            continue;
+        }
+        if (i + 1 >= tokens.size()) {
+            break;
+        }
+
+        // Group header `name (args) {` or complex attribute `name (args);`.
+        if (tokens[i + 1] == "(") {
+            std::vector<std::string> args;
+            size_t j = i + 2;
+            for (; j < tokens.size() && tokens[j] != ")"; j++) {
+                if (tokens[j] != ",") {
+                    args.push_back(tokens[j]);
+                }
+            }
+            if (j + 1 < tokens.size() && tokens[j + 1] == "{") {
+                groups.push_back(token);
+                if (token == "cell" && !args.empty()) {
+                    cellName = unquote(args.front());
+                }
+                i = j + 1;
+                continue;
+            }
+            if (token == "values" && isDelayTable(groups) && !args.empty()) {
+                record(firstNumber(args.front()));
+            }
+            i = j;
+            continue;
+        }
+
+        // Simple attribute `name : value;`.
+        if (tokens[i + 1] == ":" && i + 2 < tokens.size()) {
+            if (token == "intrinsic_rise" || token == "intrinsic_fall") {
+                record(firstNumber(tokens[i + 2]));
+            }
+            i += 2;
+        }
+    }
+
+    std::vector<double> delays;
+    for (auto &entry : library.cellDelays) {
+        delays.push_back(entry.second);
+    }
+    if (delays.empty()) {
+        log_warning("Liberty file '%s' contains no cell delays; using unit delays.\n",
+                    path.c_str());
+        return library;
+    }
+
+    std::sort(delays.begin(), delays.end());
+    library.nominalDelay = delays.at(delays.size() / 2);
+    log("Read delays of %zu cell(s) from liberty file '%s' (nominal delay %g)\n", delays.size(),
+        path.c_str(), library.nominalDelay);
+
+    return library;
+}
+
+DelayModel::DelayModel(TimingModel model, const TimingLibrary *library)
+    : model(model), library(library) {}
+
+double DelayModel::cellDelay(const RTLIL::Cell *cell) const {
+    if (model != TimingModel::Liberty || library == nullptr) {
+        return 1.0;
+    }
+    auto delay = library->cellDelays.find(cell->type);
+    return delay != library->cellDelays.end() ? delay->second : library->nominalDelay;
+}
+
+double DelayModel::clockToQ(const RTLIL::Cell *flipFlop) const {
+    if (model != TimingModel::Liberty || library == nullptr) {
+        return 0.0;
+    }
+    auto delay = library->cellDelays.find(flipFlop->type);
+    return delay != library->cellDelays.end() ? delay->second : 0.0;
+}
+
+double DelayModel::voterDelay() const {
+    if (model != TimingModel::Liberty || library == nullptr) {
+        return tmrx_voter_logic_depth;
+    }
+    return tmrx_voter_logic_depth * library->nominalDelay;
+}
+
+TimingAnalysis::TimingAnalysis(const CellGraph &graph,
+                               const std::vector<RTLIL::Cell *> &flipFlopCells,
+                               const DelayModel &delays)
+    : graph(graph), delays(delays), flipFlops(flipFlopCells.begin(), flipFlopCells.end()) {
+    dict<RTLIL::Cell *, std::vector<RTLIL::Cell *>> fanOut;
+    dict<RTLIL::Cell *, int> pending;
+    std::vector<RTLIL::Cell *> ready;
+
+    for (auto &entry : graph.fanIn) {
+        int combinationalDrivers = 0;
+        for (auto driver : entry.second) {
+            fanOut[driver].push_back(entry.first);
+            if (!flipFlops.count(driver)) {
+                combinationalDrivers++;
+            }
+        }
+        if (flipFlops.count(entry.first)) {
+            continue;
+        }
+        pending[entry.first] = combinationalDrivers;
+        if (combinationalDrivers == 0) {
+            ready.push_back(entry.first);
+        }
+    }
+
+    // Kahn's algorithm; cells on combinational loops never become ready and
+    // are left out of `order`.
+    while (!ready.empty()) {
+        RTLIL::Cell *cell = ready.back();
+        ready.pop_back();
+        order.push_back(cell);
+        for (auto sink : fanOut[cell]) {
+            if (!flipFlops.count(sink) && --pending[sink] == 0) {
+                ready.push_back(sink);
+            }
+        }
+    }
+
+    for (auto wire : graph.module->wires()) {
+        if (!wire->port_output) {
+            continue;
+        }
+        for (auto bit : graph.sigmap(wire)) {
+            auto driver = graph.drivers.find(bit);
+            if (driver != graph.drivers.end()) {
+                outputDrivers.insert(driver->second);
+            }
+        }
+    }
+
+    dict<RTLIL::Cell *, double> times = cellArrivals({});
+    for (auto flipFlop : flipFlops) {
+        arrivals[flipFlop] = inputArrival(flipFlop, times);
+    }
+
+    // Longest path from each combinational cell's inputs to a capture point.
+    dict<RTLIL::Cell *, double> required;
+    auto downstream = [&](RTLIL::Cell *cell) {
+        double longest = 0.0;
+        for (auto sink : fanOut[cell]) {
+            if (!flipFlops.count(sink) && required.count(sink)) {
+                longest = std::max(longest, required.at(sink));
+            }
+        }
+        return longest;
+    };
+    for (auto cell = order.rbegin(); cell != order.rend(); ++cell) {
+        required[*cell] = delays.cellDelay(*cell) + downstream(*cell);
+    }
+    for (auto flipFlop : flipFlops) {
+        departures[flipFlop] = delays.clockToQ(flipFlop) + downstream(flipFlop);
+    }
+}
+
+dict<RTLIL::Cell *, double>
+TimingAnalysis::cellArrivals(const dict<RTLIL::Cell *, VoterSide> &voters) const {
+    dict<RTLIL::Cell *, double> times;
+
+    for (auto flipFlop : flipFlops) {
+        auto voter = voters.find(flipFlop);
+        bool votedAfter = voter != voters.end() && voter->second == VoterSide::After;
+        times[flipFlop] = delays.clockToQ(flipFlop) + (votedAfter ? delays.voterDelay() : 0.0);
+    }
+
+    for (auto cell : order) {
+        double latest = 0.0;
+        for (auto driver : graph.fanIn.at(cell)) {
+            auto time = times.find(driver);
+            if (time != times.end()) {
+                latest = std::max(latest, time->second);
+            }
+        }
+        times[cell] = latest + delays.cellDelay(cell);
+    }
+
+    return times;
+}
+
+double TimingAnalysis::inputArrival(RTLIL::Cell *flipFlop,
+                                    const dict<RTLIL::Cell *, double> &times) const {
+    double latest = 0.0;
+    for (auto driver : graph.fanIn.at(flipFlop)) {
+        auto time = times.find(driver);
+        if (time != times.end()) {
+            latest = std::max(latest, time->second);
+        }
+    }
+    return latest;
+}
+
+double TimingAnalysis::arrival(RTLIL::Cell *flipFlop) const { return arrivals.at(flipFlop); }
+
+double TimingAnalysis::departure(RTLIL::Cell *flipFlop) const {
+    return departures.at(flipFlop);
+}
+
+VoterSide TimingAnalysis::preferredSide(RTLIL::Cell *flipFlop) const {
+    return arrival(flipFlop) < departure(flipFlop) ? VoterSide::Before : VoterSide::After;
+}
+
+double TimingAnalysis::votedPath(RTLIL::Cell *flipFlop) const {
+    return std::min(arrival(flipFlop), departure(flipFlop)) + delays.voterDelay();
+}
+
+double TimingAnalysis::worstPath(const dict<RTLIL::Cell *, VoterSide> &voters) const {
+    dict<RTLIL::Cell *, double> times = cellArrivals(voters);
+    double worst = 0.0;
+
+    for (auto flipFlop : flipFlops) {
+        auto voter = voters.find(flipFlop);
+        bool votedBefore = voter != voters.end() && voter->second == VoterSide::Before;
+        worst = std::max(worst, inputArrival(flipFlop, times) +
+                                    (votedBefore ? delays.voterDelay() : 0.0));
+    }
+    for (auto driver : outputDrivers) {
+        auto time = times.find(driver);
+        if (time != times.end()) {
+            worst = std::max(worst, time->second);
+        }
+    }
+
+    return worst;
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -0,0 +1,76 @@
+#include "tmrx_trace.h"
+#include "kernel/yosys.h"
+#include "utils.h"
+#include <fstream>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+namespace {
+
+TraceRecorder *activeRecorder = nullptr;
+
+} // namespace
+
+TraceRecorder::TraceRecorder() : origin(std::chrono::steady_clock::now()) {
+    activeRecorder = this;
+}
+
+TraceRecorder::~TraceRecorder() {
+    if (activeRecorder == this) {
+        activeRecorder = nullptr;
+    }
+}
+
+TraceRecorder *TraceRecorder::active() { return activeRecorder; }
+
+long long TraceRecorder::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 origin)
+        .count();
+}
+
+void TraceRecorder::writeJson(const std::string &path) const {
+    std::ofstream f(path);
+    if (f.fail()) {
+        log_error("Can't open trace file '%s' for writing.\n", path.c_str());
+    }
+
+    f << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event &event = events[i];
+        f << (i == 0 ? "\n" : ",\n");
+        f << "{\"name\": \"" << jsonEscape(event.name) << "\", \"cat\": \"" << event.category
+          << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << event.beginUs
+          << ", \"dur\": " << event.durationUs;
+        if (!event.detail.empty()) {
+            f << ", \"args\": {\"detail\": \"" << jsonEscape(event.detail) << "\"}";
+        }
+        f << "}";
+    }
+    f << "\n]}\n";
+
+    log("Wrote %zu TMRX trace event(s) to '%s'\n", events.size(), path.c_str());
+}
+
+TraceSpan::TraceSpan(const char *category, const std::string &name, const std::string &detail)
+    : recorder(TraceRecorder::active()), category(category) {
+    if (recorder == nullptr) {
+        return;
+    }
+    this->name = name;
+    this->detail = detail;
+    beginUs = recorder->now();
+}
+
+TraceSpan::~TraceSpan() { end(); }
+
+void TraceSpan::end() {
+    if (recorder == nullptr) {
+        return;
+    }
+    recorder->events.push_back({name, category, detail, beginUs, recorder->now() - beginUs});
+    recorder = nullptr;
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -5,8 +5,11 @@
 #include "kernel/yosys.h"
 #include "kernel/yosys_common.h"
 #include "tmrx.h"
+#include "tmrx_stats.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <sstream>
 YOSYS_NAMESPACE_BEGIN
 
 namespace TMRX {
@@ -20,7 +23,7 @@ bool isProperSubmodule(RTLIL::Module *mod) {
     return false;
 }
 
-bool isFlipFlop(const RTLIL::Cell *cell, const RTLIL::Module *module, const Config *cfg) {
+bool isFlipFlop(const RTLIL::Cell *cell, const Config *cfg) {
 
     if (cfg->excludedFfCells.count(cell->type) != 0) {
         return false;
@@ -30,8 +33,7 @@ bool isFlipFlop(const RTLIL::Cell *cell, const RTLIL::Module *module, const Conf
         return true;
     }
 
-    std::string src = cell->get_string_attribute(ID::src);
-    if (ffSources[module->name].count(src) > 0) {
+    if (cell->get_bool_attribute(ATTRIBUTE_FF)) {
         return true;
     }
 
@@ -42,6 +44,41 @@ bool isFlipFlop(const RTLIL::Cell *cell, const RTLIL::Module *module, const Conf
     return false;
 }
 
+// Re-tag cells that lost the tmrx_ff attribute to a mapping pass (dfflibmap
+// and techmap only carry `src` over to the new cell). tmrx_mark records the
+// source locations of every flip-flop in the module's tmrx_ff_sources
+// attribute; a non-internal cell sharing one of them is taken to be the
+// mapped flip-flop. Internal cells are skipped so combinational logic from
+// the same source line is not misclassified. The module attribute is consumed
+// once the cells are tagged.
+void resolveMarkedFlipFlops(RTLIL::Design *design) {
+    for (auto module : design->modules()) {
+        if (!module->has_attribute(ATTRIBUTE_FF_SOURCES)) {
+            continue;
+        }
+
+        pool<std::string> sources;
+        std::stringstream ss(module->get_string_attribute(ATTRIBUTE_FF_SOURCES));
+        std::string src;
+        while (std::getline(ss, src, tmrx_ff_source_separator)) {
+            sources.insert(src);
+        }
+        module->attributes.erase(ATTRIBUTE_FF_SOURCES);
+
+        for (auto cell : module->cells()) {
+            if (cell->type.begins_with("$") || cell->get_bool_attribute(ATTRIBUTE_FF)) {
+                continue;
+            }
+            for (auto &location : cell->get_strpool_attribute(ID::src)) {
+                if (sources.count(location) != 0) {
+                    cell->set_bool_attribute(ATTRIBUTE_FF);
+                    break;
+                }
+            }
+        }
+    }
+}
+
 // Move ids to header
 //  TODO: check attr if it is a submodule port
 bool isClkWire(const RTLIL::Wire *w, const Config *cfg) {
@@ -69,31 +106,16 @@ bool isTmrErrorOutWire(RTLIL::Wire *w, const Config *cfg) {
 }
 
 std::pair<std::vector<RTLIL::IdString>, std::vector<RTLIL::IdString>>
-getPortNames(const RTLIL::Cell *cell, const RTLIL::Design *design) {
+getPortNames(const RTLIL::Cell *cell, DesignIndex *index) {
     std::vector<RTLIL::IdString> outputs = {};
     std::vector<RTLIL::IdString> inputs = {};
 
-    const RTLIL::Module *cell_mod = design->module(cell->type);
-    if (cell_mod) {
-        const_cast<RTLIL::Module *>(cell_mod)->fixup_ports();
-        for (auto &conn : cell->connections()) {
-            const RTLIL::Wire *wire = cell_mod->wire(conn.first);
-            if (wire && wire->port_output) {
-                outputs.push_back(conn.first);
-            }
-
-            if (wire && wire->port_input) {
-                inputs.push_back(conn.first);
-            }
+    for (auto &conn : cell->connections()) {
+        if (index->isPortOutput(cell, conn.first)) {
+            outputs.push_back(conn.first);
         }
-    } else {
-        for (auto &conn : cell->connections()) {
-            if (cell->output(conn.first)) {
-                outputs.push_back(conn.first);
-            }
-            if (cell->input(conn.first)) {
-                inputs.push_back(conn.first);
-            }
+        if (index->isPortInput(cell, conn.first)) {
+            inputs.push_back(conn.first);
         }
     }
 
@@ -151,36 +173,48 @@ static std::string sanitizeIdentifierComponent(const std::string &value) {
     return result;
 }
 
-static uint64_t hashStringFnv1a(const std::string &value) {
-    uint64_t hash = 1469598103934665603ull;
-    for (unsigned char ch : value) {
-        hash ^= ch;
-        hash *= 1099511628211ull;
+static std::string appendDomainTag(const std::string &name_prefix, const std::string &domainSuffix) {
+    if (domainSuffix.empty()) {
+        return name_prefix;
     }
-    return hash;
+
+    return name_prefix + tmrx_signal_name_separator + "tmr_domain" + domainSuffix;
 }
 
-static std::string shortenIdentifierComponent(const std::string &value, size_t maxLength) {
-    if (value.size() <= maxLength) {
-        return value;
-    }
+static int levelIdBase = 0;
+static int levelIdEnd = 0;
 
-    const std::string hashSuffix = stringf("_%016llx",
-                                           static_cast<unsigned long long>(hashStringFnv1a(value)));
-    if (maxLength <= hashSuffix.size()) {
-        return hashSuffix.substr(hashSuffix.size() - maxLength);
-    }
+void beginLevelIds() {
+    levelIdBase = autoidx;
+    levelIdEnd = autoidx;
+}
 
-    return value.substr(0, maxLength - hashSuffix.size()) + hashSuffix;
+void beginModuleIds() { autoidx = levelIdBase; }
+
+void endModuleIds(int lastId) { levelIdEnd = std::max(levelIdEnd, lastId); }
+
+int endLevelIds() {
+    autoidx = levelIdEnd;
+    return levelIdEnd;
 }
 
-static std::string appendDomainTag(const std::string &name_prefix, const std::string &domainSuffix) {
-    if (domainSuffix.empty()) {
-        return name_prefix;
+namespace {
+
+// Creating a module that several expansions share draws its NEW_ID numbers
+// from the start of the level and leaves autoidx where it was, so the
+// numbers of the module being expanded do not depend on whether this
+// expansion or another one created the shared module first.
+struct SharedModuleIds {
+    SharedModuleIds() : saved(autoidx) { autoidx = levelIdBase; }
+    ~SharedModuleIds() {
+        endModuleIds(autoidx);
+        autoidx = saved;
     }
 
-    return name_prefix + tmrx_signal_name_separator + "tmr_domain" + domainSuffix;
-}
+    int saved;
+};
+
+} // namespace
 
 RTLIL::IdString createVoterCell(RTLIL::Design *design, size_t wire_width,
                                 const std::string &name_prefix) {
@@ -191,6 +225,7 @@ RTLIL::IdString createVoterCell(RTLIL::Design *design, size_t wire_width,
         return voter_name;
     }
 
+    SharedModuleIds ids;
     RTLIL::Module *voter = design->addModule(voter_name);
     voter->attributes[ID::keep_hierarchy] = RTLIL::State::S1;
 
@@ -203,7 +238,7 @@ RTLIL::IdString createVoterCell(RTLIL::Design *design, size_t wire_width,
 
     RTLIL::Wire *out_y = voter->addWire(tmrx_voter_port_y_id, wire_width);
     out_y->port_output = true;
-    RTLIL::Wire *out_err = voter->addWire(tmrx_voter_port_err_id, wire_width);
+    RTLIL::Wire *out_err = voter->addWire(tmrx_voter_port_err_id, 1);
     out_err->port_output = true;
 
     RTLIL::SigSpec pair1 = voter->And(NEW_ID, in_a, in_b);
@@ -215,24 +250,29 @@ RTLIL::IdString createVoterCell(RTLIL::Design *design, size_t wire_width,
 
     RTLIL::SigSpec err_pair1 = voter->Xor(NEW_ID, in_a, in_b);
     RTLIL::SigSpec err_pair2 = voter->Xor(NEW_ID, in_b, in_c);
-    voter->addOr(NEW_ID, err_pair1, err_pair2, out_err);
+    if (wire_width == 1) {
+        voter->addOr(NEW_ID, err_pair1, err_pair2, out_err);
+    } else {
+        // Word-level voter: any mismatching bit raises the single error flag.
+        voter->addReduceOr(NEW_ID, voter->Or(NEW_ID, err_pair1, err_pair2), out_err);
+    }
 
     voter->fixup_ports();
     return voter_name;
 }
 
-// Clone the user-supplied custom voter template into a uniquely named module
-// that follows the same \tmrx_voter_<prefix>_w1 convention as the built-in
-// voter.  Each unique name_prefix gets its own clone; subsequent calls with
-// the same prefix simply return the already-created module name.
-static RTLIL::IdString createCustomVoterCell(RTLIL::Design *design,
+// Clone the user-supplied custom voter template into a module that follows
+// the same \tmrx_voter_<prefix>_w1 convention as the built-in voter.  The
+// clone is shared by every voting site with the same prefix; subsequent calls
+// simply return the already-created module name.
+static RTLIL::IdString createCustomVoterCell(RTLIL::Design *design, DesignIndex *index,
                                              const std::string &template_module,
                                              const std::string &name_prefix) {
-    RTLIL::IdString unique_name = std::string(tmrx_voter_module_prefix) + name_prefix +
-                                  tmrx_voter_width_separator + std::to_string(1);
+    RTLIL::IdString voter_name = std::string(tmrx_voter_module_prefix) + name_prefix +
+                                 tmrx_voter_width_separator + std::to_string(1);
 
-    if (design->module(unique_name) != nullptr)
-        return unique_name;
+    if (design->module(voter_name) != nullptr)
+        return voter_name;
 
     RTLIL::IdString template_id = makeRtlilId(template_module);
     RTLIL::Module *tmpl = design->module(template_id);
@@ -240,70 +280,125 @@ static RTLIL::IdString createCustomVoterCell(RTLIL::Design *design,
         log_error("Custom voter template module '%s' not found in design.\n",
                   template_module.c_str());
 
-    RTLIL::Module *clone = design->addModule(unique_name);
+    RTLIL::Module *clone = design->addModule(voter_name);
     tmpl->cloneInto(clone);
-    clone->name = unique_name;
+    clone->name = voter_name;
     clone->attributes[ID::keep_hierarchy] = RTLIL::State::S1;
-    return unique_name;
+    index->addModule(clone);
+    return voter_name;
 }
 
-static bool isPortOutput(const RTLIL::Cell *cell, RTLIL::IdString port_name,
-                         RTLIL::Design *design) {
-    RTLIL::Module *cell_mod = design->module(cell->type);
-    if (cell_mod) {
-        cell_mod->fixup_ports();
-        RTLIL::Wire *wire = cell_mod->wire(port_name);
-        if (wire) {
-            return wire->port_output;
-        }
-    }
-    return cell->output(port_name);
+static bool isWidthParametricVoter(RTLIL::Design *design, const std::string &template_module) {
+    RTLIL::Module *tmpl = design->module(makeRtlilId(template_module));
+    return tmpl != nullptr && tmpl->avail_parameters.count(tmrx_voter_width_param_id) != 0;
 }
 
-static bool isSignalUnconnected(const RTLIL::SigSpec &sig, RTLIL::Module *module) {
-    if (sig.is_fully_const()) {
-        for (auto &bit : sig.bits()) {
-            if (bit.data == RTLIL::State::Sx || bit.data == RTLIL::State::Sz) {
-                return true;
-            }
-        }
-        return false;
-    }
+// Derive a WIDTH-wide variant of a width-parametric custom voter template and
+// register it as \tmrx_voter_<prefix>_w<N>.  The derived module must keep the
+// voter contract: a, b, c and y are N bits wide, err stays a single bit.
+static RTLIL::IdString createCustomWordVoterCell(RTLIL::Design *design, DesignIndex *index,
+                                                 const std::string &template_module,
+                                                 size_t wire_width,
+                                                 const std::string &name_prefix) {
+    RTLIL::IdString voter_name = std::string(tmrx_voter_module_prefix) + name_prefix +
+                                 tmrx_voter_width_separator + std::to_string(wire_width);
 
-    RTLIL::Design *design = module->design;
+    if (design->module(voter_name) != nullptr)
+        return voter_name;
 
-    pool<RTLIL::SigBit> driven_bits;
+    RTLIL::Module *tmpl = design->module(makeRtlilId(template_module));
+    if (tmpl == nullptr)
+        log_error("Custom voter template module '%s' not found in design.\n",
+                  template_module.c_str());
 
+    SharedModuleIds ids;
+    dict<RTLIL::IdString, RTLIL::Const> parameters;
+    parameters[tmrx_voter_width_param_id] = RTLIL::Const(static_cast<int>(wire_width), 32);
+    RTLIL::Module *derived = design->module(tmpl->derive(design, parameters));
+    if (derived == nullptr)
+        log_error("Custom voter '%s': failed to derive a %zu-bit variant.\n",
+                  template_module.c_str(), wire_width);
+
+    // Same clean-up as the template receives when it is loaded.
+    Pass::call_on_module(design, derived, "proc");
+    Pass::call_on_module(design, derived, "opt -fast");
+    derived->fixup_ports();
+
+    for (auto port : {tmrx_voter_port_a_id, tmrx_voter_port_b_id, tmrx_voter_port_c_id,
+                      tmrx_voter_port_y_id, tmrx_voter_port_err_id}) {
+        RTLIL::Wire *w = derived->wire(port);
+        size_t expected = (std::string(port) == tmrx_voter_port_err_id) ? 1 : wire_width;
+        if (w == nullptr || static_cast<size_t>(w->width) != expected)
+            log_error("Custom voter '%s': port '%s' must be %zu-bit wide for %s=%zu.\n",
+                      template_module.c_str(), port + 1, expected, tmrx_voter_width_param_name,
+                      wire_width);
+    }
+
+    design->rename(derived, voter_name);
+    derived->attributes[ID::keep_hierarchy] = RTLIL::State::S1;
+    index->addModule(derived);
+    return voter_name;
+}
+
+AnalysisContext::AnalysisContext(RTLIL::Module *module, DesignIndex *index)
+    : module(module), index(index), sigmap(module) {
     for (auto wire : module->wires()) {
         if (wire->port_input) {
-            for (int i = 0; i < wire->width; i++) {
-                driven_bits.insert(RTLIL::SigBit(wire, i));
-            }
+            addDrivers(wire);
         }
     }
 
     for (auto cell : module->cells()) {
-        for (auto &conn : cell->connections()) {
-            if (isPortOutput(cell, conn.first, design)) {
-                for (auto &bit : conn.second.bits()) {
-                    if (bit.wire != nullptr) {
-                        driven_bits.insert(bit);
-                    }
-                }
-            }
-        }
+        addCellDrivers(cell);
     }
 
     for (auto &conn : module->connections()) {
-        for (auto &bit : conn.first.bits()) {
-            if (bit.wire != nullptr) {
-                driven_bits.insert(bit);
+        addDrivers(conn.first);
+    }
+}
+
+void AnalysisContext::connect(const RTLIL::SigSpec &lhs, const RTLIL::SigSpec &rhs) {
+    module->connect(lhs, rhs);
+    sigmap.add(lhs, rhs);
+    addDrivers(lhs);
+}
+
+void AnalysisContext::addDrivers(const RTLIL::SigSpec &sig) {
+    for (auto &bit : sig.bits()) {
+        if (bit.wire != nullptr) {
+            drivenBits.insert(bit);
+        }
+    }
+}
+
+void AnalysisContext::addCellDrivers(const RTLIL::Cell *cell) {
+    for (auto &conn : cell->connections()) {
+        if (isPortOutput(cell, conn.first)) {
+            addDrivers(conn.second);
+        }
+    }
+}
+
+bool AnalysisContext::isDriven(const RTLIL::SigBit &bit) const {
+    return drivenBits.count(bit) != 0;
+}
+
+bool AnalysisContext::isPortOutput(const RTLIL::Cell *cell, RTLIL::IdString port) {
+    return index->isPortOutput(cell, port);
+}
+
+static bool isSignalUnconnected(const RTLIL::SigSpec &sig, const AnalysisContext &ctx) {
+    if (sig.is_fully_const()) {
+        for (auto &bit : sig.bits()) {
+            if (bit.data == RTLIL::State::Sx || bit.data == RTLIL::State::Sz) {
+                return true;
             }
         }
+        return false;
     }
 
     for (auto &bit : sig.bits()) {
-        if (bit.wire != nullptr && driven_bits.count(bit) == 0) {
+        if (bit.wire != nullptr && !ctx.isDriven(bit)) {
             return true;
         }
     }
@@ -324,35 +419,47 @@ static bool isSignalConstant(const RTLIL::SigSpec &sig) {
 }
 
 std::pair<RTLIL::Wire *, RTLIL::Wire *>
-insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, const Config *cfg,
+insertVoter(AnalysisContext &ctx, const std::vector<RTLIL::SigSpec> &inputs, const Config *cfg,
             const std::string &domainSuffix) {
     if (inputs.size() != tmrx_replication_factor) {
         log_error("Voters are only intended to be inserted with %zu inputs\n",
                   tmrx_replication_factor);
     }
 
+    RTLIL::Module *module = ctx.module;
     RTLIL::Design *design = module->design;
     size_t wire_width = inputs.at(0).size();
 
-    std::string sig_name_a = getSignalName(inputs.at(0));
-    std::string sig_name_b = getSignalName(inputs.at(1));
-    std::string sig_name_c = getSignalName(inputs.at(2));
-
-    std::string modName = module->name.str();
-    if (!modName.empty() && modName[0] == '\\')
-        modName = modName.substr(1);
-
-    std::string name_prefix = modName + tmrx_signal_name_separator + sig_name_a +
-                              tmrx_signal_name_separator + sig_name_b + tmrx_signal_name_separator +
-                              sig_name_c;
+    // Voter definitions are shared: their name only depends on the voter kind,
+    // width and TMR domain.  The voting site is recorded on each instance.
+    std::string voter_kind = (cfg->tmrVoter == TmrVoter::Custom)
+                                 ? tmrx_voter_custom_kind_prefix + cfg->tmrVoterModule
+                                 : std::string(tmrx_voter_default_kind);
     std::string voter_name_prefix =
-        shortenIdentifierComponent(sanitizeIdentifierComponent(appendDomainTag(name_prefix, domainSuffix)),
-                                   72);
+        sanitizeIdentifierComponent(appendDomainTag(voter_kind, domainSuffix));
+
+    // Voting the same triple again only needs a fresh output wire; the error
+    // wire is shared and deduplicated when the error tree is built.
+    AnalysisContext::VoterKey voter_key = {ctx.sigmap(inputs.at(0)), ctx.sigmap(inputs.at(1)),
+                                           ctx.sigmap(inputs.at(2)), voter_name_prefix,
+                                           cfg->tmrVoterWordLevel};
+    auto cached = ctx.voterCache.find(voter_key);
+    if (cached != ctx.voterCache.end()) {
+        RTLIL::Wire *reused_wire = module->addWire(NEW_ID, wire_width);
+        ctx.connect(reused_wire, cached->second.first);
+        ctx.reusedVoters++;
+        return {reused_wire, cached->second.second};
+    }
+
+    std::string voter_site = appendDomainTag(
+        getSignalName(inputs.at(0)) + tmrx_signal_name_separator + getSignalName(inputs.at(1)) +
+            tmrx_signal_name_separator + getSignalName(inputs.at(2)),
+        domainSuffix);
 
     if (cfg->tmrVoterSafeMode) {
         for (size_t i = 0; i < tmrx_replication_factor; i++) {
             const RTLIL::SigSpec &sig = inputs.at(i);
-            if (isSignalUnconnected(sig, module)) {
+            if (isSignalUnconnected(sig, ctx)) {
                 log_error("TMRX Safe Mode: Voter input '%s' in module '%s' is not connected "
                           "(signal: %s). "
                           "All voter inputs must be driven.\n",
@@ -367,30 +474,41 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
         }
     } else {
         // Optimization: if all 3 inputs are electrically identical, skip voter insertion.
-        SigMap sigmap(module);
-        if (sigmap(inputs.at(0)) == sigmap(inputs.at(1)) &&
-            sigmap(inputs.at(1)) == sigmap(inputs.at(2))) {
+        if (ctx.sigmap(inputs.at(0)) == ctx.sigmap(inputs.at(1)) &&
+            ctx.sigmap(inputs.at(1)) == ctx.sigmap(inputs.at(2))) {
             RTLIL::Wire *last_wire = module->addWire(NEW_ID, wire_width);
             RTLIL::Wire *err_wire = module->addWire(NEW_ID, 1);
-            module->connect(last_wire, inputs.at(0));
-            module->connect(err_wire, RTLIL::SigSpec(RTLIL::State::S0, 1));
+            ctx.connect(last_wire, inputs.at(0));
+            ctx.connect(err_wire, RTLIL::SigSpec(RTLIL::State::S0, 1));
+            ctx.voterCache[voter_key] = {last_wire, err_wire};
             return {last_wire, err_wire};
         }
     }
 
-    // Resolve the 1-bit voter cell: both paths produce a uniquely named module
-    // following the \tmrx_voter_<prefix>_w1 convention.
-    RTLIL::IdString voter_1bit =
-        (cfg->tmrVoter == TmrVoter::Custom)
-            ? createCustomVoterCell(design, cfg->tmrVoterModule, voter_name_prefix)
-            : createVoterCell(design, 1, voter_name_prefix);
+    // Resolve the voter cell: all paths produce a shared module following the
+    // \tmrx_voter_<kind>[_tmr_domain<suffix>]_w<N> convention.  In word-level mode
+    // one N-bit voter covers the whole signal; custom voters qualify only if
+    // they are width-parametric, otherwise one 1-bit voter is used per bit.
+    bool word_level = cfg->tmrVoterWordLevel && wire_width > 1;
+    RTLIL::IdString voter_type;
+    if (cfg->tmrVoter == TmrVoter::Custom) {
+        word_level = word_level && isWidthParametricVoter(design, cfg->tmrVoterModule);
+        voter_type = word_level ? createCustomWordVoterCell(design, ctx.index,
+                                                            cfg->tmrVoterModule, wire_width,
+                                                            voter_name_prefix)
+                                : createCustomVoterCell(design, ctx.index, cfg->tmrVoterModule,
+                                                        voter_name_prefix);
+    } else {
+        voter_type = createVoterCell(design, word_level ? wire_width : 1, voter_name_prefix);
+    }
+    size_t voter_width = word_level ? wire_width : 1;
 
     RTLIL::SigSpec output_bits;
     RTLIL::SigSpec error_bits;
 
     // Resolve the voter's clock and reset port names.
     // Config option takes priority over the tmrx_clk_port / tmrx_rst_port Verilog attribute.
-    RTLIL::Module *voter_mod_ptr = design->module(voter_1bit);
+    RTLIL::Module *voter_mod_ptr = design->module(voter_type);
     RTLIL::IdString voter_clk_port;
     RTLIL::IdString voter_rst_port;
 
@@ -432,7 +550,7 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
             if (!parent_clk_wire)
                 log_warning("Custom voter '%s': tmr_voter_clock_net '%s' not found in "
                             "parent module '%s'.\n",
-                            voter_1bit.c_str(), cfg->tmrVoterClockNet.c_str(),
+                            voter_type.c_str(), cfg->tmrVoterClockNet.c_str(),
                             module->name.c_str());
         } else {
             for (auto wire : module->wires()) {
@@ -444,7 +562,7 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
             if (!parent_clk_wire)
                 log_warning("Custom voter '%s': clock port '%s' specified but no clock "
                             "wire found in parent module '%s'.\n",
-                            voter_1bit.c_str(), voter_clk_port.c_str(), module->name.c_str());
+                            voter_type.c_str(), voter_clk_port.c_str(), module->name.c_str());
         }
     }
 
@@ -454,7 +572,7 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
             if (!parent_rst_wire)
                 log_warning("Custom voter '%s': tmr_voter_reset_net '%s' not found in "
                             "parent module '%s'.\n",
-                            voter_1bit.c_str(), cfg->tmrVoterResetNet.c_str(),
+                            voter_type.c_str(), cfg->tmrVoterResetNet.c_str(),
                             module->name.c_str());
         } else {
             for (auto wire : module->wires()) {
@@ -466,29 +584,34 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
             if (!parent_rst_wire)
                 log_warning("Custom voter '%s': reset port '%s' specified but no reset "
                             "wire found in parent module '%s'.\n",
-                            voter_1bit.c_str(), voter_rst_port.c_str(), module->name.c_str());
+                            voter_type.c_str(), voter_rst_port.c_str(), module->name.c_str());
         }
     }
 
-    for (size_t bit = 0; bit < wire_width; bit++) {
-        RTLIL::Wire *bit_out = module->addWire(NEW_ID, 1);
-        RTLIL::Wire *bit_err = module->addWire(NEW_ID, 1);
+    for (size_t offset = 0; offset < wire_width; offset += voter_width) {
+        RTLIL::Wire *slice_out = module->addWire(NEW_ID, voter_width);
+        RTLIL::Wire *slice_err = module->addWire(NEW_ID, 1);
 
-        RTLIL::Cell *voter_inst = module->addCell(NEW_ID, voter_1bit);
+        RTLIL::Cell *voter_inst = module->addCell(NEW_ID, voter_type);
+        ctx.index->addCell(voter_inst);
+        countVoters(1);
         setCellDomainAttribute(voter_inst, domainSuffix);
-        voter_inst->setPort(tmrx_voter_port_a_id, inputs.at(0).extract(bit, 1));
-        voter_inst->setPort(tmrx_voter_port_b_id, inputs.at(1).extract(bit, 1));
-        voter_inst->setPort(tmrx_voter_port_c_id, inputs.at(2).extract(bit, 1));
-        voter_inst->setPort(tmrx_voter_port_y_id, bit_out);
-        voter_inst->setPort(tmrx_voter_port_err_id, bit_err);
+        voter_inst->set_string_attribute(ATTRIBUTE_VOTER_SITE, voter_site);
+        voter_inst->setPort(tmrx_voter_port_a_id, inputs.at(0).extract(offset, voter_width));
+        voter_inst->setPort(tmrx_voter_port_b_id, inputs.at(1).extract(offset, voter_width));
+        voter_inst->setPort(tmrx_voter_port_c_id, inputs.at(2).extract(offset, voter_width));
+        voter_inst->setPort(tmrx_voter_port_y_id, slice_out);
+        voter_inst->setPort(tmrx_voter_port_err_id, slice_err);
 
         if (!voter_clk_port.empty() && parent_clk_wire)
             voter_inst->setPort(voter_clk_port, parent_clk_wire);
         if (!voter_rst_port.empty() && parent_rst_wire)
             voter_inst->setPort(voter_rst_port, parent_rst_wire);
 
-        output_bits.append(bit_out);
-        error_bits.append(bit_err);
+        ctx.addDrivers(slice_out);
+        ctx.addDrivers(slice_err);
+        output_bits.append(slice_out);
+        error_bits.append(slice_err);
     }
 
     if (!domainSuffix.empty() && voter_mod_ptr != nullptr) {
@@ -497,21 +620,193 @@ insertVoter(RTLIL::Module *module, const std::vector<RTLIL::SigSpec> &inputs, co
         }
     }
 
-    // Reassemble N-bit output from individual bit results.
+    // Reassemble N-bit output from the individual voter results.
     RTLIL::Wire *last_wire = module->addWire(NEW_ID, wire_width);
-    module->connect(last_wire, output_bits);
+    ctx.connect(last_wire, output_bits);
 
-    // Collapse per-bit errors into a single 1-bit error flag.
+    // Collapse per-voter errors into a single 1-bit error flag.
     RTLIL::Wire *err_wire = module->addWire(NEW_ID, 1);
-    if (wire_width == 1) {
-        module->connect(err_wire, error_bits);
+    if (error_bits.size() == 1) {
+        ctx.connect(err_wire, error_bits);
     } else {
-        module->connect(err_wire, module->ReduceOr(NEW_ID, error_bits));
+        RTLIL::SigSpec reduced = module->ReduceOr(NEW_ID, error_bits);
+        ctx.addDrivers(reduced);
+        ctx.connect(err_wire, reduced);
     }
 
+    ctx.voterCache[voter_key] = {last_wire, err_wire};
     return {last_wire, err_wire};
 }
 
+// Clock or reset for registered error aggregation: the first input port
+// recognised by `isPort`, or the expanded first-path copy of one of `names`
+// when that net was triplicated.
+static RTLIL::Wire *findErrorControl(RTLIL::Module *mod, const Config *cfg,
+                                     bool (*isPort)(const RTLIL::Wire *, const Config *),
+                                     const pool<RTLIL::IdString> &names) {
+    for (auto wire : mod->wires()) {
+        if (wire->port_input && isPort(wire, cfg)) {
+            return wire;
+        }
+    }
+
+    for (auto wire : mod->wires()) {
+        if (!wire->port_input) {
+            continue;
+        }
+        for (auto &name : names) {
+            if (wire->name.str() == name.str() + cfg->logicPath1Suffix) {
+                return wire;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+int errorLatency(const RTLIL::Wire *wire) {
+    auto it = wire->attributes.find(ATTRIBUTE_ERROR_LATENCY);
+    return it == wire->attributes.end() ? 0 : it->second.as_int();
+}
+
+void setErrorLatency(RTLIL::Wire *wire, int latency) {
+    if (latency > 0) {
+        wire->attributes[ATTRIBUTE_ERROR_LATENCY] = RTLIL::Const(latency);
+    } else {
+        wire->attributes.erase(ATTRIBUTE_ERROR_LATENCY);
+    }
+}
+
+namespace {
+
+// Register stages of the error aggregation. They clear on the module's reset
+// when a flip-flop of the module shows its polarity, and otherwise start at
+// zero through an init value, so the error output is never X.
+struct ErrorRegisters {
+    RTLIL::Module *mod;
+    RTLIL::Wire *clk = nullptr;
+    RTLIL::Wire *rst = nullptr;
+    bool rstPolarity = false;
+
+    ErrorRegisters(RTLIL::Module *mod, const Config *cfg) : mod(mod) {
+        clk = findErrorControl(mod, cfg, isClkWire, cfg->clockPortNames);
+        RTLIL::Wire *reset = findErrorControl(mod, cfg, isRstWire, cfg->resetPortNames);
+        if (reset == nullptr) {
+            return;
+        }
+        for (auto cell : mod->cells()) {
+            if (cell->type == ID($adff) && cell->getPort(ID::ARST) == RTLIL::SigSpec(reset)) {
+                rst = reset;
+                rstPolarity = cell->getParam(ID::ARST_POLARITY).as_bool();
+                return;
+            }
+        }
+    }
+
+    RTLIL::SigSpec stage(const RTLIL::SigSpec &d) {
+        RTLIL::Wire *q = mod->addWire(NEW_ID, d.size());
+        if (rst != nullptr) {
+            mod->addAdff(NEW_ID, clk, rst, d, q, RTLIL::Const(RTLIL::State::S0, d.size()), true,
+                         rstPolarity);
+        } else {
+            mod->addDff(NEW_ID, clk, d, q);
+            q->attributes[ID::init] = RTLIL::Const(RTLIL::State::S0, d.size());
+        }
+        return q;
+    }
+};
+
+} // namespace
+
+// OR all error signals into one bit using a balanced tree of cells with at
+// most error_tree_fan_in inputs each (0 = a single $reduce_or), so the depth
+// of the error path grows logarithmically with the number of voters.
+//
+// Child error ports arrive with the latency of the child's tree. Earlier
+// signals are first delayed to the latest arrival. With
+// error_register_levels = K, a register stage then follows every K-th tree
+// level and the last one, so every voter below this module reaches the result
+// after the same number of cycles. Returns the result and that latency.
+static std::pair<RTLIL::SigSpec, int>
+buildErrorTree(RTLIL::Module *mod, const std::vector<RTLIL::Wire *> &error_signals,
+               const Config *cfg) {
+    // Reused voters hand out the same error wire more than once.
+    std::vector<RTLIL::Wire *> inputs;
+    pool<RTLIL::Wire *> seen;
+    int arrival = 0;
+    bool skewed = false;
+    for (auto s : error_signals) {
+        if (!seen.insert(s).second) {
+            continue;
+        }
+        skewed = skewed || (!inputs.empty() && errorLatency(s) != arrival);
+        arrival = std::max(arrival, errorLatency(s));
+        inputs.push_back(s);
+    }
+
+    if (inputs.empty()) {
+        return {RTLIL::State::S0, 0};
+    }
+
+    ErrorRegisters registers(mod, cfg);
+    bool registered = cfg->errorRegisterLevels > 0 && inputs.size() > 1;
+    if ((registered || skewed) && registers.clk == nullptr) {
+        log_warning("Module '%s': error signals need register stages but no clock port was "
+                    "found. Error aggregation is not registered.\n",
+                    mod->name.c_str());
+        registered = false;
+        skewed = false;
+    }
+
+    // Delay line: a signal joins it once its own latency is reached.
+    RTLIL::SigSpec level;
+    int padding = 0;
+    for (int latency = 0; latency <= arrival; latency++) {
+        if (skewed && !level.empty()) {
+            level = registers.stage(level);
+            padding++;
+        }
+        for (auto s : inputs) {
+            if (!skewed ? latency == arrival : errorLatency(s) == latency) {
+                level.append(s);
+            }
+        }
+    }
+
+    int group_size = cfg->errorTreeFanIn > 0 ? cfg->errorTreeFanIn : level.size();
+    int depth = 0;
+    int stages = 0;
+    while (level.size() > 1) {
+        RTLIL::SigSpec next;
+        for (int offset = 0; offset < level.size(); offset += group_size) {
+            RTLIL::SigSpec group =
+                level.extract(offset, std::min(group_size, level.size() - offset));
+            if (group.size() == 1) {
+                next.append(group);
+            } else if (group.size() == 2) {
+                next.append(mod->Or(NEW_ID, group[0], group[1]));
+            } else {
+                next.append(mod->ReduceOr(NEW_ID, group));
+            }
+        }
+
+        depth++;
+        if (registered && (depth % cfg->errorRegisterLevels == 0 || next.size() == 1)) {
+            next = registers.stage(next);
+            stages++;
+        }
+        level = next;
+    }
+
+    if (padding > 0 || stages > 0) {
+        log("  Error aggregation in '%s': %d level(s), %d register stage(s), %d padding "
+            "stage(s), latency %d cycle(s)\n",
+            mod->name.c_str(), depth, stages, padding, arrival + stages);
+    }
+
+    return {level, arrival + stages};
+}
+
 void connectErrorSignal(RTLIL::Module *mod, const std::vector<RTLIL::Wire *> &error_signals,
                         const Config *cfg) {
 
@@ -535,11 +830,9 @@ void connectErrorSignal(RTLIL::Module *mod, const std::vector<RTLIL::Wire *> &er
         log("  Auto-created error port '%s' in module '%s'\n", port_name.c_str(),
             mod->name.c_str());
 
-        RTLIL::SigSpec aggregated = RTLIL::State::S0;
-        for (auto s : error_signals) {
-            aggregated = mod->Or(NEW_ID, aggregated, s);
-        }
+        auto [aggregated, latency] = buildErrorTree(mod, error_signals, cfg);
         mod->connect(new_port, aggregated);
+        setErrorLatency(new_port, latency);
         return;
     }
 
@@ -555,11 +848,14 @@ void connectErrorSignal(RTLIL::Module *mod, const std::vector<RTLIL::Wire *> &er
         new_error->attributes = sink->attributes;
         mod->fixup_ports();
 
-        RTLIL::SigSpec last_wire = sink;
-        for (auto s : error_signals) {
-            last_wire = mod->Or(NEW_ID, last_wire, s);
-        }
-        mod->connect(new_error, last_wire);
+        // The user's own error logic on the sink goes through the tree as
+        // well, so it has the same latency as the voter errors.
+        std::vector<RTLIL::Wire *> signals = error_signals;
+        signals.push_back(sink);
+        auto [aggregated, latency] = buildErrorTree(mod, signals, cfg);
+        aggregated.extend_u0(new_error->width);
+        mod->connect(new_error, aggregated);
+        setErrorLatency(new_error, latency);
     }
 }
 } // namespace TMRX
@@ -0,0 +1,319 @@
+#include "tmrx_voter_placement.h"
+#include "kernel/rtlil.h"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <utility>
+
+YOSYS_NAMESPACE_BEGIN
+namespace TMRX {
+namespace {
+
+using CellFanIn = dict<RTLIL::Cell *, std::vector<RTLIL::Cell *>>;
+
+// Record in `sources` the flip-flops (by node id) whose outputs reach `root`
+// through combinational cells only, memoizing every cell visited on the way.
+// The walk is iterative so long combinational chains cannot exhaust the stack.
+void traceSources(RTLIL::Cell *root, const CellFanIn &fanIn,
+                  const dict<RTLIL::Cell *, int> &nodeIds,
+                  dict<RTLIL::Cell *, std::vector<int>> &sources) {
+    if (sources.count(root)) {
+        return;
+    }
+
+    pool<RTLIL::Cell *> visiting;
+    std::vector<std::pair<RTLIL::Cell *, bool>> stack = {{root, false}};
+
+    while (!stack.empty()) {
+        auto [cell, expanded] = stack.back();
+        stack.pop_back();
+
+        if (expanded) {
+            std::vector<int> ids;
+            for (auto driver : fanIn.at(cell)) {
+                auto node = nodeIds.find(driver);
+                if (node != nodeIds.end()) {
+                    ids.push_back(node->second);
+                    continue;
+                }
+                // Only missing on a combinational loop, which adds no register edge.
+                auto known = sources.find(driver);
+                if (known != sources.end()) {
+                    ids.insert(ids.end(), known->second.begin(), known->second.end());
+                }
+            }
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            sources[cell] = std::move(ids);
+            continue;
+        }
+
+        if (sources.count(cell) || !visiting.insert(cell).second) {
+            continue;
+        }
+
+        stack.push_back({cell, true});
+        for (auto driver : fanIn.at(cell)) {
+            if (!nodeIds.count(driver) && !sources.count(driver) && !visiting.count(driver)) {
+                stack.push_back({driver, false});
+            }
+        }
+    }
+}
+
+// Greedy feedback vertex set over the register dependency graph.
+struct FeedbackCut {
+    std::vector<pool<int>> preds;
+    std::vector<pool<int>> succs;
+    std::vector<bool> removed;
+    std::vector<long long> score;
+    std::vector<double> cost;
+    // (-score, cost, id): best candidate first
+    std::set<std::tuple<long long, double, int>> ranking;
+    std::vector<int> worklist;
+
+    explicit FeedbackCut(size_t nodes)
+        : preds(nodes), succs(nodes), removed(nodes, false), score(nodes, 0), cost(nodes, 0.0) {}
+
+    void addEdge(int from, int to) {
+        succs[from].insert(to);
+        preds[to].insert(from);
+    }
+
+    long long currentScore(int v) const {
+        return static_cast<long long>(preds[v].size()) * static_cast<long long>(succs[v].size());
+    }
+
+    void rank(int v) {
+        score[v] = currentScore(v);
+        ranking.insert({-score[v], cost[v], v});
+        if (preds[v].empty() || succs[v].empty()) {
+            worklist.push_back(v);
+        }
+    }
+
+    void touch(int v) {
+        if (removed[v]) {
+            return;
+        }
+        ranking.erase({-score[v], cost[v], v});
+        rank(v);
+    }
+
+    void drop(int v) {
+        ranking.erase({-score[v], cost[v], v});
+        removed[v] = true;
+
+        std::vector<int> neighbours;
+        for (int u : succs[v]) {
+            if (u != v) {
+                preds[u].erase(v);
+                neighbours.push_back(u);
+            }
+        }
+        for (int u : preds[v]) {
+            if (u != v) {
+                succs[u].erase(v);
+                neighbours.push_back(u);
+            }
+        }
+        preds[v].clear();
+        succs[v].clear();
+
+        for (int u : neighbours) {
+            touch(u);
+        }
+    }
+
+    std::vector<int> solve() {
+        std::vector<int> cut;
+        int nodes = static_cast<int>(preds.size());
+
+        for (int v = 0; v < nodes; v++) {
+            if (preds[v].count(v)) {
+                cut.push_back(v);
+                drop(v);
+            }
+        }
+        for (int v = 0; v < nodes; v++) {
+            if (!removed[v]) {
+                ranking.erase({-score[v], cost[v], v});
+                rank(v);
+            }
+        }
+
+        while (true) {
+            while (!worklist.empty()) {
+                int v = worklist.back();
+                worklist.pop_back();
+                if (!removed[v] && (preds[v].empty() || succs[v].empty())) {
+                    drop(v);
+                }
+            }
+            if (ranking.empty()) {
+                break;
+            }
+            int v = std::get<2>(*ranking.begin());
+            cut.push_back(v);
+            drop(v);
+        }
+
+        return cut;
+    }
+};
+
+} // namespace
+
+CellGraph::CellGraph(RTLIL::Module *mod, const std::vector<RTLIL::Cell *> &cells,
+                     DesignIndex *index)
+    : module(mod), sigmap(mod) {
+    for (auto cell : cells) {
+        for (auto &conn : cell->connections()) {
+            if (!index->isPortOutput(cell, conn.first)) {
+                continue;
+            }
+            for (auto bit : sigmap(conn.second)) {
+                if (bit.wire != nullptr) {
+                    drivers[bit] = cell;
+                }
+            }
+        }
+    }
+
+    for (auto cell : cells) {
+        std::vector<RTLIL::Cell *> cellDrivers;
+        pool<RTLIL::Cell *> seen;
+        for (auto &conn : cell->connections()) {
+            if (!index->isPortInput(cell, conn.first)) {
+                continue;
+            }
+            for (auto bit : sigmap(conn.second)) {
+                auto driver = drivers.find(bit);
+                if (driver == drivers.end()) {
+                    if (bit.wire != nullptr) {
+                        undrivenReaders[bit].push_back(cell);
+                    }
+                    continue;
+                }
+                if (seen.insert(driver->second).second) {
+                    cellDrivers.push_back(driver->second);
+                }
+            }
+        }
+        fanIn[cell] = std::move(cellDrivers);
+    }
+}
+
+pool<RTLIL::Cell *> selectFeedbackCutFlipFlops(const CellGraph &graph,
+                                               const std::vector<RTLIL::Cell *> &flipFlops,
+                                               const dict<RTLIL::Cell *, double> *cost) {
+    std::vector<RTLIL::Cell *> nodes(flipFlops.begin(), flipFlops.end());
+    std::sort(nodes.begin(), nodes.end(), [](const RTLIL::Cell *a, const RTLIL::Cell *b) {
+        return a->name.str() < b->name.str();
+    });
+
+    dict<RTLIL::Cell *, int> nodeIds;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodeIds[nodes[i]] = static_cast<int>(i);
+    }
+
+    dict<RTLIL::Cell *, std::vector<int>> sources;
+    FeedbackCut cut(nodes.size());
+
+    for (size_t v = 0; v < nodes.size(); v++) {
+        if (cost != nullptr && cost->count(nodes[v])) {
+            cut.cost[v] = cost->at(nodes[v]);
+        }
+        for (auto driver : graph.fanIn.at(nodes[v])) {
+            auto node = nodeIds.find(driver);
+            if (node != nodeIds.end()) {
+                cut.addEdge(node->second, static_cast<int>(v));
+                continue;
+            }
+            traceSources(driver, graph.fanIn, nodeIds, sources);
+            for (int u : sources.at(driver)) {
+                cut.addEdge(u, static_cast<int>(v));
+            }
+        }
+    }
+
+    pool<RTLIL::Cell *> cutFlipFlops;
+    for (int v : cut.solve()) {
+        cutFlipFlops.insert(nodes[v]);
+    }
+    return cutFlipFlops;
+}
+
+pool<RTLIL::Cell *> selectBoundaryFlipFlops(const CellGraph &graph,
+                                            const std::vector<RTLIL::Cell *> &flipFlops,
+                                            const std::vector<RTLIL::Wire *> &inputs,
+                                            const std::vector<RTLIL::Wire *> &outputs) {
+    pool<RTLIL::Cell *> isFlipFlop(flipFlops.begin(), flipFlops.end());
+    dict<RTLIL::Cell *, std::vector<RTLIL::Cell *>> fanOut;
+    for (auto &entry : graph.fanIn) {
+        for (auto driver : entry.second) {
+            fanOut[driver].push_back(entry.first);
+        }
+    }
+
+    // Forward from the inputs, stopping at the first flip-flop on each path.
+    pool<RTLIL::Cell *> fromInput;
+    std::vector<RTLIL::Cell *> queue;
+    for (auto wire : inputs) {
+        for (auto bit : graph.sigmap(wire)) {
+            auto readers = graph.undrivenReaders.find(bit);
+            if (readers == graph.undrivenReaders.end()) {
+                continue;
+            }
+            for (auto cell : readers->second) {
+                if (fromInput.insert(cell).second) {
+                    queue.push_back(cell);
+                }
+            }
+        }
+    }
+    while (!queue.empty()) {
+        RTLIL::Cell *cell = queue.back();
+        queue.pop_back();
+        if (isFlipFlop.count(cell) || !fanOut.count(cell)) {
+            continue;
+        }
+        for (auto reader : fanOut.at(cell)) {
+            if (fromInput.insert(reader).second) {
+                queue.push_back(reader);
+            }
+        }
+    }
+
+    // Backward from the outputs through every cell.
+    pool<RTLIL::Cell *> toOutput;
+    for (auto wire : outputs) {
+        for (auto bit : graph.sigmap(wire)) {
+            auto driver = graph.drivers.find(bit);
+            if (driver != graph.drivers.end() && toOutput.insert(driver->second).second) {
+                queue.push_back(driver->second);
+            }
+        }
+    }
+    while (!queue.empty()) {
+        RTLIL::Cell *cell = queue.back();
+        queue.pop_back();
+        for (auto driver : graph.fanIn.at(cell)) {
+            if (toOutput.insert(driver).second) {
+                queue.push_back(driver);
+            }
+        }
+    }
+
+    pool<RTLIL::Cell *> boundary;
+    for (auto ff : flipFlops) {
+        if (fromInput.count(ff) && toOutput.count(ff)) {
+            boundary.insert(ff);
+        }
+    }
+    return boundary;
+}
+
+} // namespace TMRX
+YOSYS_NAMESPACE_END
@@ -1,3 +1,78 @@
 #include "utils.h"
+#include "libs/sha1/sha1.h"
+#include <cstdio>
+#include <dlfcn.h>
+#include <fstream>
+#include <unistd.h>
 
 USING_YOSYS_NAMESPACE
+
+std::string TMRX::jsonEscape(const std::string &text) {
+    std::string res;
+    for (char ch : text) {
+        switch (ch) {
+        case '"':
+            res += "\\\"";
+            break;
+        case '\\':
+            res += "\\\\";
+            break;
+        case '\n':
+            res += "\\n";
+            break;
+        default:
+            // Other control characters are not allowed raw in a JSON string.
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                res += stringf("\\u%04x", static_cast<unsigned char>(ch));
+            } else {
+                res += ch;
+            }
+        }
+    }
+    return res;
+}
+
+std::string TMRX::contentHash(const std::string &data) {
+    SHA1 sha1;
+    sha1.update(data);
+    return sha1.final();
+}
+
+std::string TMRX::pluginBuildId() {
+    static const std::string buildId = [] {
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void *>(&TMRX::contentHash), &info) != 0 &&
+            info.dli_fname != nullptr) {
+            std::ifstream in(info.dli_fname, std::ios::binary);
+            if (in) {
+                SHA1 sha1;
+                sha1.update(in);
+                return sha1.final();
+            }
+        }
+        return std::string(__DATE__ " " __TIME__);
+    }();
+    return buildId;
+}
+
+bool TMRX::writeFileAtomically(const std::string &path, const std::string &contents) {
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) {
+        create_directory(path.substr(0, slash));
+    }
+
+    std::string tmpPath = stringf("%s.%d.tmp", path.c_str(), getpid());
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        out << contents;
+        if (out.fail()) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Scaling regression test for LogicTMR expansion.
+
+Generates single-module designs of increasing size with gen_design.py, runs
+`tmrx_mark; tmrx -stats` on each and fits the growth exponent k of
+runtime ~ cells^k by least squares on a log-log scale. The fit is done for
+the whole module expansion and for every expansion phase, so a helper that
+turns quadratic in duplication, voter insertion or error wiring is caught
+even if other phases dominate the total.
+
+Phases that stay below --min-seconds on the largest design are reported but
+not checked, since their timings are mostly noise.
+
+Exit code is 0 if every checked exponent is within --max-exponent.
+"""
+
+import argparse
+import json
+import math
+import pathlib
+import subprocess
+import sys
+from types import SimpleNamespace
+
+import gen_design
+
+
+def fit_exponent(points):
+    xs = [math.log(cells) for cells, _ in points]
+    ys = [math.log(max(seconds, 1e-6)) for _, seconds in points]
+    mean_x = sum(xs) / len(xs)
+    mean_y = sum(ys) / len(ys)
+    num = sum((x - mean_x) * (y - mean_y) for x, y in zip(xs, ys))
+    den = sum((x - mean_x) ** 2 for x in xs)
+    return num / den
+
+
+def run_size(args, cells, workdir):
+    workdir.mkdir(parents=True, exist_ok=True)
+    il_path = workdir / "design.il"
+    config_path = workdir / "tmrx_config.toml"
+    stats_path = workdir / "tmrx_stats.json"
+
+    gen_args = SimpleNamespace(
+        out_il=str(il_path), out_config=str(config_path), argv=[f"--cells {cells}"],
+        top="scale_top", depth=0, fanout=0, cells=cells, width=args.width,
+        ff_ratio=args.ff_ratio, full_module_ratio=0.0, seed=args.seed)
+    gen_design.generate(gen_args)
+
+    script = workdir / "scale.ys"
+    script.write_text(
+        f"read_rtlil {il_path}\n"
+        "hierarchy -check -top scale_top\n"
+        "tmrx_mark\n"
+        f"tmrx -c {config_path} -stats {stats_path}\n"
+    )
+    result = subprocess.run([args.yosys, "-q", "-l", str(workdir / "scale.log"), "-m",
+                             args.tmrx_so, "-s", str(script)])
+    if result.returncode != 0:
+        print(f"ERROR: yosys failed on {cells} cells (exit {result.returncode})",
+              file=sys.stderr)
+        sys.exit(result.returncode)
+
+    (module,) = json.loads(stats_path.read_text())["modules"]
+    return module
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__,
+                                formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--yosys",        required=True)
+    p.add_argument("--tmrx-so",      required=True)
+    p.add_argument("--workdir",      required=True)
+    p.add_argument("--sizes",        type=int, nargs="+", default=[1000, 10000, 100000])
+    p.add_argument("--width",        type=int, default=1)
+    p.add_argument("--ff-ratio",     type=float, default=0.2)
+    p.add_argument("--seed",         type=int, default=1)
+    p.add_argument("--max-exponent", type=float, default=1.25)
+    p.add_argument("--min-seconds",  type=float, default=0.2)
+    args = p.parse_args()
+
+    if len(args.sizes) < 2:
+        p.error("--sizes needs at least two design sizes")
+
+    workdir = pathlib.Path(args.workdir)
+    runs = []
+    for cells in sorted(args.sizes):
+        module = run_size(args, cells, workdir / f"cells_{cells}")
+        print(f"{cells:>9} cells: {module['seconds']:.3f}s, {module['voters_created']} voter(s)")
+        runs.append((cells, module))
+
+    series = {"total": [(cells, module["seconds"]) for cells, module in runs]}
+    for cells, module in runs:
+        for phase in module["phases"]:
+            series.setdefault(phase["name"], []).append((cells, phase["seconds"]))
+
+    failed = False
+    for name, points in series.items():
+        if len(points) != len(runs):
+            continue
+        exponent = fit_exponent(points)
+        largest = points[-1][1]
+        checked = largest >= args.min_seconds
+        verdict = "ok"
+        if not checked:
+            verdict = "not checked"
+        elif exponent > args.max_exponent:
+            verdict = "SUPER-LINEAR"
+            failed = True
+        print(f"{name:>22}: exponent {exponent:.2f} ({largest:.3f}s at largest size) {verdict}")
+
+    if failed:
+        print(f"Runtime grows faster than cells^{args.max_exponent}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""Synthetic design generator for the TMRX benchmarks.
+
+Writes an RTLIL design and a matching TMRX configuration. Every module has the
+same interface (clk_i, rst_ni, in_i[W], out_o[W]) and computes a random chain
+of word-level cells over its input, with a share of the chain registered and
+its child instances spliced into the chain. The hierarchy is a tree: each
+module below `--depth` instantiates `--fanout` distinct child modules.
+
+The output only depends on the arguments, so runs with the same parameters
+are comparable across commits.
+"""
+
+import argparse
+import random
+import sys
+
+BINARY_OPS = ["$and", "$or", "$xor", "$add"]
+
+
+class ModuleWriter:
+    def __init__(self, name, width):
+        self.name = name
+        self.width = width
+        self.lines = []
+        self.connections = []
+        self.signals = []
+
+    def wire(self, name):
+        self.lines.append(f"  wire width {self.width} \\{name}")
+        self.signals.append(f"\\{name}")
+        return f"\\{name}"
+
+    def cell(self, cell_type, name, params, ports):
+        self.lines.append(f"  cell {cell_type} \\{name}")
+        for key, value in params:
+            self.lines.append(f"    parameter \\{key} {value}")
+        for key, value in ports:
+            self.lines.append(f"    connect \\{key} {value}")
+        self.lines.append("  end")
+
+
+def binary_params(width):
+    return [
+        ("A_SIGNED", 0), ("A_WIDTH", width),
+        ("B_SIGNED", 0), ("B_WIDTH", width),
+        ("Y_WIDTH", width),
+    ]
+
+
+def write_module(out, name, children, args, rng):
+    w = args.width
+    m = ModuleWriter(name, w)
+    header = [
+        f"module \\{name}",
+        "  wire input 1 \\clk_i",
+        "  wire input 2 \\rst_ni",
+        f"  wire width {w} input 3 \\in_i",
+        f"  wire width {w} output 4 \\out_o",
+    ]
+
+    prev = "\\in_i"
+    m.signals.append(prev)
+
+    def instantiate(child, sig):
+        child_out = m.wire(f"{child}_out")
+        m.cell(f"\\{child}", f"u_{child}", [], [
+            ("clk_i", "\\clk_i"), ("rst_ni", "\\rst_ni"), ("in_i", sig), ("out_o", child_out),
+        ])
+        return child_out
+
+    # Child instances are spread evenly over the chain.
+    splice_every = max(1, args.cells // (len(children) + 1))
+    pending = list(children)
+
+    for i in range(args.cells):
+        out_sig = m.wire(f"n{i}")
+        if rng.random() < args.ff_ratio:
+            m.cell("$adff", f"ff{i}", [
+                ("WIDTH", w), ("CLK_POLARITY", 1), ("ARST_POLARITY", 0),
+                ("ARST_VALUE", f"{w}'" + "0" * w),
+            ], [("CLK", "\\clk_i"), ("ARST", "\\rst_ni"), ("D", prev), ("Q", out_sig)])
+        else:
+            other = rng.choice(m.signals[:-1])
+            kind = rng.random()
+            if kind < 0.1:
+                m.cell("$not", f"c{i}", [("A_SIGNED", 0), ("A_WIDTH", w), ("Y_WIDTH", w)],
+                       [("A", prev), ("Y", out_sig)])
+            elif kind < 0.25:
+                m.cell("$mux", f"c{i}", [("WIDTH", w)],
+                       [("A", prev), ("B", other), ("S", f"{other} [0]"), ("Y", out_sig)])
+            else:
+                m.cell(rng.choice(BINARY_OPS), f"c{i}", binary_params(w),
+                       [("A", prev), ("B", other), ("Y", out_sig)])
+        prev = out_sig
+
+        if pending and (i + 1) % splice_every == 0:
+            prev = instantiate(pending.pop(0), prev)
+
+    while pending:
+        prev = instantiate(pending.pop(0), prev)
+
+    m.connections.append(f"  connect \\out_o {prev}")
+    out.write("\n".join(header + m.lines + m.connections + ["end", ""]))
+
+
+def build_hierarchy(args):
+    """Return (name, children) pairs, leaves first."""
+    levels = [[args.top]]
+    for depth in range(args.depth):
+        levels.append([f"{parent}_{i}" for parent in levels[-1] for i in range(args.fanout)])
+
+    modules = []
+    for depth in reversed(range(len(levels))):
+        for name in levels[depth]:
+            children = ([f"{name}_{i}" for i in range(args.fanout)]
+                        if depth < args.depth else [])
+            modules.append((name, children))
+    return modules
+
+
+def write_config(out, modules, args, rng):
+    out.write("[global]\n")
+    out.write('tmr_mode = "LogicTMR"\n')
+    out.write("preserve_module_ports = false\n")
+    out.write('clock_port_names = ["clk_i"]\n')
+    out.write('reset_port_names = ["rst_ni"]\n')
+    out.write("\n[global.logic]\n")
+    out.write("insert_voter_after_ff = true\n")
+    out.write(f"\n[module.{args.top}]\n")
+    out.write("preserve_module_ports = true\n")
+
+    for name, _ in modules:
+        if name != args.top and rng.random() < args.full_module_ratio:
+            out.write(f"\n[module.{name}]\n")
+            out.write('tmr_mode = "FullModuleTMR"\n')
+            out.write("preserve_module_ports = true\n")
+
+
+def generate(args):
+    rng = random.Random(args.seed)
+    modules = build_hierarchy(args)
+    with open(args.out_il, "w") as f:
+        f.write(f"# Generated by gen_design.py {' '.join(args.argv)}\n")
+        for name, children in modules:
+            write_module(f, name, children, args, rng)
+    with open(args.out_config, "w") as f:
+        f.write(f"# Generated by gen_design.py {' '.join(args.argv)}\n")
+        write_config(f, modules, args, rng)
+    return len(modules)
+
+
+def add_arguments(p):
+    p.add_argument("--top",               default="bench_top")
+    p.add_argument("--depth",             type=int,   default=0,
+                   help="Levels of hierarchy below the top module")
+    p.add_argument("--fanout",            type=int,   default=2,
+                   help="Child modules instantiated by every non-leaf module")
+    p.add_argument("--cells",             type=int,   default=100,
+                   help="Word-level cells per module")
+    p.add_argument("--width",             type=int,   default=8,
+                   help="Bus width of every signal")
+    p.add_argument("--ff-ratio",          type=float, default=0.2,
+                   help="Share of cells that are flip-flops")
+    p.add_argument("--full-module-ratio", type=float, default=0.0,
+                   help="Share of non-top modules expanded with FullModuleTMR")
+    p.add_argument("--seed",              type=int,   default=1)
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__)
+    p.add_argument("--out-il",     required=True)
+    p.add_argument("--out-config", required=True)
+    add_arguments(p)
+    args = p.parse_args()
+    args.argv = sys.argv[1:]
+    count = generate(args)
+    print(f"Generated {count} module(s) into {args.out_il}")
+
+
+if __name__ == "__main__":
+    main()
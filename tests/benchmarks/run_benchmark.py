@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Run one TMRX benchmark and compare it against its stored baseline.
+
+By default a synthetic design is built with gen_design.py (all generator
+options are accepted) and run through
+
+    read_rtlil; hierarchy; tmrx_mark; tmrx -c <config> -stats <report>
+
+With --command, an existing flow (such as croc) is run instead; it must write
+a `tmrx -stats` report to the path given by --stats.
+
+Reported figures: wall time of the tmrx pass and of the whole run, peak RSS
+of the yosys process, the design's cell count after tmrx and the number of
+voters inserted. They are written to <workdir>/result.json.
+
+Baselines are kept in a JSON file keyed by benchmark name. Cell and voter
+counts must match exactly, since the output only depends on the input; time
+and memory may exceed the baseline by the given tolerances. A benchmark
+without a baseline only reports. --update-baselines stores the current run.
+
+Exit code is 0 if no regression was found, 1 otherwise.
+"""
+
+import argparse
+import json
+import pathlib
+import resource
+import subprocess
+import sys
+import time
+
+import gen_design
+
+EXACT_METRICS = ["cells", "voters"]
+TOLERATED_METRICS = [("tmrx_seconds", "time_tolerance"), ("peak_rss_kb", "memory_tolerance")]
+
+
+def run_yosys(args, workdir, stats_path):
+    il_path = workdir / "design.il"
+    config_path = workdir / "tmrx_config.toml"
+    args.out_il = str(il_path)
+    args.out_config = str(config_path)
+    args.argv = sys.argv[1:]
+    gen_design.generate(args)
+
+    script = workdir / "bench.ys"
+    script.write_text(
+        f"read_rtlil {il_path}\n"
+        f"hierarchy -check -top {args.top}\n"
+        "tmrx_mark\n"
+        f"tmrx -c {config_path} -stats {stats_path}\n"
+    )
+    return [args.yosys, "-q", "-l", str(workdir / "bench.log"), "-m", args.tmrx_so,
+            "-s", str(script)]
+
+
+def measure(cmd, cwd):
+    start = time.monotonic()
+    result = subprocess.run(cmd, cwd=str(cwd))
+    seconds = time.monotonic() - start
+    if result.returncode != 0:
+        print(f"ERROR: benchmark command failed (exit {result.returncode})", file=sys.stderr)
+        sys.exit(result.returncode)
+    # ru_maxrss of the largest descendant; kilobytes on Linux.
+    child_rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    return seconds, child_rss
+
+
+def compare(name, result, baseline, args):
+    failures = []
+    for metric in EXACT_METRICS:
+        if metric in baseline and result[metric] != baseline[metric]:
+            failures.append(f"{metric}: {result[metric]} != baseline {baseline[metric]}")
+    for metric, tolerance_arg in TOLERATED_METRICS:
+        if metric not in baseline:
+            continue
+        limit = baseline[metric] * (1.0 + getattr(args, tolerance_arg))
+        if result[metric] > limit:
+            failures.append(f"{metric}: {result[metric]:.6g} > {limit:.6g} "
+                            f"(baseline {baseline[metric]:.6g})")
+
+    for failure in failures:
+        print(f"[{name}] REGRESSION {failure}")
+    return not failures
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__,
+                                formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--name",             required=True)
+    p.add_argument("--workdir",          required=True)
+    p.add_argument("--baselines",        required=True)
+    p.add_argument("--yosys",            default="yosys")
+    p.add_argument("--tmrx-so",          default=None)
+    p.add_argument("--command",          nargs=argparse.REMAINDER, default=None,
+                   help="Run this flow instead of a generated design (must be last)")
+    p.add_argument("--command-cwd",      default=None)
+    p.add_argument("--stats",            default=None,
+                   help="tmrx -stats report written by --command")
+    p.add_argument("--time-tolerance",   type=float, default=1.0,
+                   help="Allowed relative slowdown of the tmrx pass (default: 1.0 = 2x)")
+    p.add_argument("--memory-tolerance", type=float, default=0.25,
+                   help="Allowed relative growth of peak RSS (default: 0.25)")
+    p.add_argument("--update-baselines", action="store_true")
+    gen_design.add_arguments(p)
+    args = p.parse_args()
+
+    workdir = pathlib.Path(args.workdir)
+    workdir.mkdir(parents=True, exist_ok=True)
+
+    if args.command:
+        if not args.stats:
+            p.error("--command requires --stats")
+        stats_path = pathlib.Path(args.stats)
+        cmd = args.command
+        cwd = pathlib.Path(args.command_cwd) if args.command_cwd else workdir
+    else:
+        if not args.tmrx_so:
+            p.error("--tmrx-so is required for generated designs")
+        stats_path = workdir / "tmrx_stats.json"
+        cmd = run_yosys(args, workdir, stats_path)
+        cwd = workdir
+
+    if stats_path.exists():
+        stats_path.unlink()
+    seconds, child_rss = measure(cmd, cwd)
+    totals = json.loads(stats_path.read_text())["totals"]
+
+    result = {
+        "tmrx_seconds": totals["seconds"],
+        "total_seconds": seconds,
+        "peak_rss_kb": max(child_rss, totals["peak_rss_kb"]),
+        "cells": totals["design_cells"],
+        "voters": totals["voters_created"],
+        "modules": totals["modules"],
+    }
+    (workdir / "result.json").write_text(json.dumps(result, indent=2) + "\n")
+    print(f"[{args.name}] tmrx {result['tmrx_seconds']:.3f}s, total {seconds:.3f}s, "
+          f"peak RSS {result['peak_rss_kb']} kB, {result['cells']} cell(s), "
+          f"{result['voters']} voter(s), {result['modules']} module(s)")
+
+    baselines_path = pathlib.Path(args.baselines)
+    baselines = json.loads(baselines_path.read_text()) if baselines_path.exists() else {}
+
+    if args.update_baselines:
+        baselines[args.name] = {key: result[key] for key in
+                                ["tmrx_seconds", "peak_rss_kb", "cells", "voters"]}
+        baselines_path.write_text(json.dumps(baselines, indent=2, sort_keys=True) + "\n")
+        print(f"[{args.name}] baseline updated in {baselines_path}")
+        return 0
+
+    if args.name not in baselines:
+        print(f"[{args.name}] no baseline stored, reporting only")
+        return 0
+
+    return 0 if compare(args.name, result, baselines[args.name], args) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -rf tmrx_cache config_cache_*.log config_cache_out*.v
+
+# First run resolves the configs and writes the cache.
+"${yosys_bin}" -ql config_cache_1.log -m "${plugin_path}" -s config_cache.ys
+grep -Fq "Wrote 3 module configuration(s) to config cache" config_cache_1.log
+grep -Fq "full_module.shared_worker has no effect" config_cache_1.log
+mv config_cache_out.v config_cache_out_1.v
+
+# Second run loads them and produces the same netlist.
+"${yosys_bin}" -ql config_cache_2.log -m "${plugin_path}" -s config_cache.ys
+grep -Fq "Loaded 3 module configuration(s) from config cache" config_cache_2.log
+grep -Fq "full_module.shared_worker has no effect" config_cache_2.log
+if grep -Fq "Wrote 3 module configuration(s)" config_cache_2.log; then
+    echo "cache was rewritten on a hit" >&2
+    exit 1
+fi
+cmp config_cache_out_1.v config_cache_out.v
+
+# A changed config file selects a new cache file.
+"${yosys_bin}" -ql config_cache_3.log -m "${plugin_path}" -s config_cache_changed.ys
+grep -Fq "Wrote 3 module configuration(s) to config cache" config_cache_3.log
+test "$(ls tmrx_cache/*.tmrxcfg | wc -l)" -eq 2
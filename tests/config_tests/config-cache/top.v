@@ -0,0 +1,52 @@
+// Two submodules with different configs, used to test the -config-cache option.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire       d_i,
+    output wire [1:0] q_o
+);
+    voted u_voted (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[0])
+    );
+
+    plain u_plain (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[1])
+    );
+endmodule
+
+module voted (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
+
+(* tmrx_tmr_mode = "None" *)
+module plain (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+run_case() {
+  local config_file="$1"
+  local or_count="$2"
+  local reduce_or_count="$3"
+  local dff_count="$4"
+  local top_file="${5:-top.v}"
+  sed \
+    -e "s|TOP_FILE|${top_file}|g" \
+    -e "s|CONFIG_FILE|${config_file}|g" \
+    -e "s|REDUCE_OR_COUNT|${reduce_or_count}|g" \
+    -e "s|DFF_COUNT|${dff_count}|g" \
+    -e "s|OR_COUNT|${or_count}|g" \
+    emit_error_tree.ys > run.ys
+
+  "${yosys_bin}" -q -m "${plugin_path}" -s run.ys
+}
+
+# The design itself contributes 8 x 3 = 24 triplicated $dff cells.
+
+# 24 voter errors, fan-in 2: balanced binary tree of 23 $or cells.
+run_case fan_in_2_tmrx_config.toml 23 0 24
+
+# 24 voter errors, fan-in 4: 24 -> 6 -> 2 -> 1, i.e. 6 + 1 $reduce_or and 1 + 1 $or.
+run_case fan_in_4_tmrx_config.toml 2 7 24
+
+# Fan-in 2 with a register stage every 2 levels and after the last one:
+# 24 -> 12 -> 6 (reg) -> 3 -> 2 (reg) -> 1 (reg), adding three $dff stages to the tree.
+run_case registered_tmrx_config.toml 23 0 27
+
+# Across the hierarchy, the parent delays its own voter errors to the child's
+# registered error instead of registering the child's error again.
+"${yosys_bin}" -q -m "${plugin_path}" -s emit_error_latency.ys
+
+# The same settings given as module attributes, in integer and string form,
+# override the fan-in 2 config.
+with_attrs() {
+  sed "s|^module top|(* $1 *)\nmodule top|" top.v > attr_top.v
+}
+with_attrs 'tmrx_error_tree_fan_in = 4'
+run_case fan_in_2_tmrx_config.toml 2 7 24 attr_top.v
+with_attrs 'tmrx_error_tree_fan_in = "4"'
+run_case fan_in_2_tmrx_config.toml 2 7 24 attr_top.v
+with_attrs 'tmrx_error_register_levels = 2'
+run_case fan_in_2_tmrx_config.toml 23 0 27 attr_top.v
+with_attrs 'tmrx_error_register_levels = "2"'
+run_case fan_in_2_tmrx_config.toml 23 0 27 attr_top.v
+
+# A non-numeric attribute value is reported, not a crash.
+with_attrs 'tmrx_error_tree_fan_in = "abc"'
+sed -e "s|TOP_FILE|attr_top.v|g" -e "s|CONFIG_FILE|fan_in_2_tmrx_config.toml|g" \
+  emit_error_tree.ys > run.ys
+if "${yosys_bin}" -ql invalid_attr.log -m "${plugin_path}" -s run.ys; then
+  echo "tmrx_error_tree_fan_in = \"abc\" was accepted" >&2
+  exit 1
+fi
+grep -Fq "attribute 'tmrx_error_tree_fan_in' must be an integer (got 'abc')" invalid_attr.log
+
+with_attrs 'tmrx_error_register_levels = "2x"'
+sed -e "s|TOP_FILE|attr_top.v|g" -e "s|CONFIG_FILE|fan_in_2_tmrx_config.toml|g" \
+  emit_error_tree.ys > run.ys
+if "${yosys_bin}" -ql invalid_attr.log -m "${plugin_path}" -s run.ys; then
+  echo "tmrx_error_register_levels = \"2x\" was accepted" >&2
+  exit 1
+fi
+grep -Fq "attribute 'tmrx_error_register_levels' must be an integer (got '2x')" invalid_attr.log
+
+# A fan-in of 1 cannot reduce anything and must be rejected.
+sed -e "s|TOP_FILE|top.v|g" -e "s|CONFIG_FILE|fan_in_1_tmrx_config.toml|g" emit_error_tree.ys > run.ys
+if "${yosys_bin}" -ql invalid.log -m "${plugin_path}" -s run.ys; then
+  echo "error_tree_fan_in = 1 was accepted" >&2
+  exit 1
+fi
+grep -Fq "error_tree_fan_in must be 0 or at least 2" invalid.log
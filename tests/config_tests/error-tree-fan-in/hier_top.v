@@ -0,0 +1,41 @@
+// A registered child and a parent register, used to test that every voter
+// error reaches the top error port after the same number of cycles.
+module unit (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire [1:0] d_i,
+    output wire [1:0] q_o
+);
+    reg q0, q1;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q0 <= 1'b0;
+        else q0 <= d_i[0];
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q1 <= 1'b0;
+        else q1 <= d_i[1];
+
+    assign q_o = {q1, q0};
+endmodule
+
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire [2:0] d_i,
+    output wire [2:0] q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i[2];
+
+    unit u_unit (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i[1:0]),
+        .q_o(q_o[1:0])
+    );
+
+    assign q_o[2] = q_q;
+endmodule
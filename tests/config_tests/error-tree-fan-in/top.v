@@ -0,0 +1,21 @@
+// Eight independent 1-bit registers.  With LogicTMR every register gets one
+// voter per TMR domain, giving 24 single-bit voter error signals to aggregate.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire [7:0] d_i,
+    output wire [7:0] q_o
+);
+    reg q0, q1, q2, q3, q4, q5, q6, q7;
+
+    always @(posedge clk_i) q0 <= d_i[0];
+    always @(posedge clk_i) q1 <= d_i[1];
+    always @(posedge clk_i) q2 <= d_i[2];
+    always @(posedge clk_i) q3 <= d_i[3];
+    always @(posedge clk_i) q4 <= d_i[4];
+    always @(posedge clk_i) q5 <= d_i[5];
+    always @(posedge clk_i) q6 <= d_i[6];
+    always @(posedge clk_i) q7 <= d_i[7];
+
+    assign q_o = {q7, q6, q5, q4, q3, q2, q1, q0};
+endmodule
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f tmrx_stats.json
+
+"${yosys_bin}" -ql feedback_cut_hierarchy.log -m "${plugin_path}" -s feedback_cut_hierarchy.ys
+
+# The child's register has no loop of its own, but it is fed from an input
+# and drives an output, so it stays in the cut.
+grep -Fq "Feedback cut: voting 1 of 1 flip-flop(s), 0 voter site(s) saved" \
+    feedback_cut_hierarchy.log
+
+python3 - <<'PY'
+import json
+
+with open("tmrx_stats.json") as f:
+    stats = json.load(f)
+
+modules = {module["name"]: module for module in stats["modules"]}
+phases = {phase["name"]: phase for phase in modules["count_reg"]["phases"]}
+
+# 4 register bits, one voter per bit and domain.
+assert phases["ff_voting"]["voters_created"] == 12, phases["ff_voting"]
+PY
@@ -0,0 +1,33 @@
+// Counter whose register sits in a child module and whose increment sits in
+// the parent. The child's only loop closes through the parent.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    output wire [3:0] count_o
+);
+    wire [3:0] count;
+
+    count_reg u_count_reg (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(count + 4'h1),
+        .q_o(count)
+    );
+
+    assign count_o = count;
+endmodule
+
+module count_reg (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire [3:0] d_i,
+    output wire [3:0] q_o
+);
+    reg [3:0] q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 4'h0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
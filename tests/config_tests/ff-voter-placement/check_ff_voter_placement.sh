@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f tmrx_stats.json
+
+"${yosys_bin}" -ql ff_voter_placement.log -m "${plugin_path}" -s ff_voter_placement.ys
+
+# Six flip-flop cells; the counter and one ring register form the cut, the
+# other four each save three voter sites.
+grep -Fq "Feedback cut: voting 2 of 6 flip-flop(s), 12 voter site(s) saved" ff_voter_placement.log
+
+python3 - <<'PY'
+import json
+
+with open("tmrx_stats.json") as f:
+    stats = json.load(f)
+
+(top,) = stats["modules"]
+phases = {phase["name"]: phase for phase in top["phases"]}
+assert "ff_placement" in phases, phases
+
+# 4 counter bits + 1 ring bit, one voter per bit and domain.
+assert phases["ff_voting"]["voters_created"] == 15, phases["ff_voting"]
+PY
@@ -0,0 +1,36 @@
+// Pipeline, counter and two-register ring used to test feedback-cut voter
+// placement. Only the counter and one ring register lie on feedback loops.
+module top (
+    input  wire        clk_i,
+    input  wire        rst_ni,
+    input  wire        en_i,
+    input  wire [7:0]  data_i,
+    output wire [7:0]  data_o,
+    output wire [3:0]  count_o,
+    output wire        ring_o
+);
+    reg [7:0] stage1_q, stage2_q, stage3_q;
+    reg [3:0] count_q;
+    reg       ring_a_q, ring_b_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) begin
+            stage1_q <= 8'h0;
+            stage2_q <= 8'h0;
+            stage3_q <= 8'h0;
+            count_q  <= 4'h0;
+            ring_a_q <= 1'b0;
+            ring_b_q <= 1'b0;
+        end else begin
+            stage1_q <= data_i;
+            stage2_q <= stage1_q;
+            stage3_q <= stage2_q;
+            if (en_i) count_q <= count_q + 4'h1;
+            ring_a_q <= ring_b_q ^ en_i;
+            ring_b_q <= ring_a_q;
+        end
+
+    assign data_o  = stage3_q;
+    assign count_o = count_q;
+    assign ring_o  = ring_b_q;
+endmodule
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -rf tmrx_module_cache incremental_*.log incremental_out*.v
+
+# First run expands every module and fills the cache.
+"${yosys_bin}" -ql incremental_1.log -m "${plugin_path}" -s incremental.ys
+grep -Fq "Module cache: 0 module(s) restored, 3 expanded" incremental_1.log
+mv incremental_out.v incremental_out_1.v
+
+# Nothing changed: every module is restored and the netlist is the same.
+"${yosys_bin}" -ql incremental_2.log -m "${plugin_path}" -s incremental.ys
+grep -Fq "Module cache: 3 module(s) restored, 0 expanded" incremental_2.log
+cmp incremental_out_1.v incremental_out.v
+
+# Editing b_unit invalidates it and its parent; a_unit is still restored.
+"${yosys_bin}" -ql incremental_3.log -m "${plugin_path}" -s incremental_edit.ys
+grep -Fq "Module cache: 1 module(s) restored, 2 expanded" incremental_3.log
+grep -Fq "Restored 'a_unit' from module cache" incremental_3.log
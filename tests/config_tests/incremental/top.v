@@ -0,0 +1,56 @@
+// Two independent units, used to test tmrx -incremental. EDIT_B_UNIT changes
+// b_unit only; a_unit comes first so its src attributes do not move.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire       d_i,
+    output wire [1:0] q_o
+);
+    a_unit u_a (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[0])
+    );
+
+    b_unit u_b (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[1])
+    );
+endmodule
+
+module a_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
+
+module b_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+`ifdef EDIT_B_UNIT
+        else q_q <= ~d_i;
+`else
+        else q_q <= d_i;
+`endif
+
+    assign q_o = q_q;
+endmodule
@@ -0,0 +1,10 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f marked.il
+
+"${yosys_bin}" -ql mark.log -m "${plugin_path}" -s mark.ys
+"${yosys_bin}" -ql expand.log -m "${plugin_path}" -s expand.ys
@@ -0,0 +1,5 @@
+// Maps the fine-grained async-reset FF onto lib_dff. Like dfflibmap, techmap
+// keeps only the `src` attribute of the replaced cell.
+module \$_DFF_PN0_ (input D, input C, input R, output Q);
+    lib_dff _TECHMAP_REPLACE_ (.D(D), .CLK(C), .RN(R), .Q(Q));
+endmodule
@@ -0,0 +1,9 @@
+// Stand-in for a liberty flip-flop with an active-low asynchronous reset.
+(* blackbox *)
+module lib_dff (
+    input  wire D,
+    input  wire CLK,
+    input  wire RN,
+    output wire Q
+);
+endmodule
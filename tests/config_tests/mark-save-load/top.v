@@ -0,0 +1,16 @@
+// 8-bit counter whose flip-flops are mapped to a library cell after tmrx_mark.
+// Used to test that the flip-flop marking survives design save/load and a
+// new yosys process.
+module top (
+    input  wire        clk_i,
+    input  wire        rst_ni,
+    output wire [7:0]  count_o
+);
+    reg [7:0] count_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) count_q <= 8'h0;
+        else count_q <= count_q + 8'h1;
+
+    assign count_o = count_q;
+endmodule
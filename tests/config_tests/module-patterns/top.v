@@ -0,0 +1,103 @@
+module top (
+    input wire clk_i,
+    input wire rst_ni,
+    input wire d_i,
+    output wire [3:0] q_o
+);
+    cdc_sync u_cdc_sync (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[0])
+    );
+    cdc_slow u_cdc_slow (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[1])
+    );
+    cdc_fast u_cdc_fast (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[2])
+    );
+    dm_csrs u_dm_csrs (
+        .clk_i(clk_i),
+        .rst_ni(rst_ni),
+        .d_i(d_i),
+        .q_o(q_o[3])
+    );
+endmodule
+
+module cdc_sync (
+    input wire clk_i,
+    input wire rst_ni,
+    input wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni)
+            q_q <= 1'b0;
+        else
+            q_q <= d_i;
+    end
+
+    assign q_o = q_q;
+endmodule
+
+module cdc_slow (
+    input wire clk_i,
+    input wire rst_ni,
+    input wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni)
+            q_q <= 1'b0;
+        else
+            q_q <= d_i;
+    end
+
+    assign q_o = q_q;
+endmodule
+
+module cdc_fast (
+    input wire clk_i,
+    input wire rst_ni,
+    input wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni)
+            q_q <= 1'b0;
+        else
+            q_q <= d_i;
+    end
+
+    assign q_o = q_q;
+endmodule
+
+module dm_csrs (
+    input wire clk_i,
+    input wire rst_ni,
+    input wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni)
+            q_q <= 1'b0;
+        else
+            q_q <= d_i;
+    end
+
+    assign q_o = q_q;
+endmodule
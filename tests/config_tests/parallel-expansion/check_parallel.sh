@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f parallel_*.log parallel_out_*.v
+
+checks="select -assert-count 3 a_unit_tmrx_impl/t:\$adff; \
+select -assert-count 3 b_unit_tmrx_impl/t:\$adff; \
+select -assert-count 3 c_unit/t:c_unit_*; \
+select -assert-count 3 e_unit/t:e_unit_*; \
+select -assert-count 1 d_leaf_a/t:\$adff"
+
+for jobs in 1 4; do
+    "${yosys_bin}" -ql "parallel_${jobs}.log" -m "${plugin_path}" -p "script parallel_prep.ys; \
+        tmrx -c tmrx_config.toml -j ${jobs}; ${checks}; \
+        write_verilog -noattr parallel_out_${jobs}.v"
+done
+
+# Levels 0 and 1 hold two expanded modules each.
+grep -Fq "Expanding 2 module(s) in 2 worker process(es)" parallel_4.log
+if grep -Fq "worker process" parallel_1.log; then
+    echo "tmrx -j 1 started worker processes" >&2
+    exit 1
+fi
+
+cmp parallel_out_1.v parallel_out_4.v
@@ -0,0 +1,77 @@
+// Two hierarchy levels with more than one module each, used to test tmrx -j.
+// a_unit and b_unit are LogicTMR leaves that share voters; c_unit and e_unit
+// are FullModuleTMR parents that both uniquify d_leaf.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire       d_i,
+    output wire [3:0] q_o
+);
+    a_unit u_a (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(d_i), .q_o(q_o[0]));
+    b_unit u_b (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(d_i), .q_o(q_o[1]));
+    c_unit u_c (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(d_i), .q_o(q_o[2]));
+    e_unit u_e (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(d_i), .q_o(q_o[3]));
+endmodule
+
+module a_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
+
+module b_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg [1:0] q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 2'b0;
+        else q_q <= {q_q[0], d_i};
+
+    assign q_o = q_q[1];
+endmodule
+
+module c_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    d_leaf u_d (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(d_i), .q_o(q_o));
+endmodule
+
+module e_unit (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    d_leaf u_d (.clk_i(clk_i), .rst_ni(rst_ni), .d_i(~d_i), .q_o(q_o));
+endmodule
+
+module d_leaf (
+    input  wire clk_i,
+    input  wire rst_ni,
+    input  wire d_i,
+    output wire q_o
+);
+    reg q_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) q_q <= 1'b0;
+        else q_q <= d_i;
+
+    assign q_o = q_q;
+endmodule
@@ -0,0 +1,16 @@
+// Registered adder used to test the TMR domain tags of replicated cells.
+module top (
+    input  wire        clk_i,
+    input  wire        rst_ni,
+    input  wire [7:0]  a_i,
+    input  wire [7:0]  b_i,
+    output wire [7:0]  sum_o
+);
+    reg [7:0] sum_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) sum_q <= 8'h0;
+        else sum_q <= a_i + b_i;
+
+    assign sum_o = sum_q;
+endmodule
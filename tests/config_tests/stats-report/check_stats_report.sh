@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f tmrx_stats.json
+
+"${yosys_bin}" -ql stats_report.log -m "${plugin_path}" -s stats_report.ys
+
+grep -Fq "Wrote TMRX statistics for 1 module(s) to 'tmrx_stats.json'" stats_report.log
+
+python3 - <<'PY'
+import json
+
+with open("tmrx_stats.json") as f:
+    stats = json.load(f)
+
+(top,) = stats["modules"]
+assert top["name"] == "top" and top["mode"] == "LogicTMR", top
+phases = {phase["name"]: phase for phase in top["phases"]}
+for name in ("clock_reset_nets", "duplication", "ff_voting", "error_wiring"):
+    assert name in phases, name
+
+# 8 flip-flop bits, one voter per bit and domain.
+assert phases["ff_voting"]["voters_created"] == 24, phases["ff_voting"]
+assert phases["duplication"]["cells_created"] > 0, phases["duplication"]
+assert stats["totals"]["voters_created"] == top["voters_created"], stats["totals"]
+assert stats["totals"]["modules"] == 1, stats["totals"]
+PY
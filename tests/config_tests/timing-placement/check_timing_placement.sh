@@ -0,0 +1,11 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+"${yosys_bin}" -ql timing_placement.log -m "${plugin_path}" -s timing_placement.ys
+
+# in_q is voted on its outputs and out_q on its inputs, so neither three-cell
+# cone gains the three-level voter and the worst path stays at 3.
+grep -Fq "Timing (LogicDepth): worst estimated path 3 before TMR, 3 after; voting 1 flip-flop(s) on their inputs, 1 on their outputs" timing_placement.log
@@ -0,0 +1,19 @@
+// Two registers used to test timing-aware voter placement: in_q sits after a
+// three-cell input cone, out_q before a three-cell output cone.
+module top (
+    input  wire       clk_i,
+    input  wire [7:0] data_i,
+    input  wire [7:0] key_i,
+    output wire [7:0] early_o,
+    output wire [7:0] late_o
+);
+    reg [7:0] in_q, out_q;
+
+    always @(posedge clk_i) begin
+        in_q  <= ((data_i + 8'd3) ^ key_i) + data_i;
+        out_q <= data_i;
+    end
+
+    assign early_o = in_q;
+    assign late_o  = ((out_q + 8'd5) ^ key_i) + key_i;
+endmodule
@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+yosys_bin="$1"
+plugin_path="$2"
+
+rm -f tmrx_trace.json
+
+"${yosys_bin}" -ql trace_profile.log -m "${plugin_path}" -s trace_profile.ys
+
+grep -Fq "TMRX trace event(s) to 'tmrx_trace.json'" trace_profile.log
+
+python3 - <<'PY'
+import json
+
+with open("tmrx_trace.json") as f:
+    events = json.load(f)["traceEvents"]
+
+spans = {}
+for event in events:
+    assert event["ph"] == "X", event
+    spans.setdefault(event["name"], []).append(event)
+
+for name in ("tmrx", "ConfigManager", "level 0", "top", "duplication", "ff voters", "cleanup"):
+    assert name in spans, name
+
+
+def contains(outer, inner):
+    return (outer["ts"] <= inner["ts"]
+            and inner["ts"] + inner["dur"] <= outer["ts"] + outer["dur"])
+
+
+(run,) = spans["tmrx"]
+(top,) = spans["top"]
+(ff_voters,) = spans["ff voters"]
+assert top["args"]["detail"] == "LogicTMR", top
+assert contains(run, spans["ConfigManager"][0])
+assert contains(run, top)
+assert contains(top, ff_voters)
+PY
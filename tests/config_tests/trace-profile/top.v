@@ -0,0 +1,15 @@
+// Simple counter used to test the -trace Chrome trace output.
+module top (
+    input  wire        clk_i,
+    input  wire        rst_ni,
+    input  wire        en_i,
+    output wire [7:0]  count_o
+);
+    reg [7:0] count_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) count_q <= 8'h0;
+        else if (en_i) count_q <= count_q + 8'h1;
+
+    assign count_o = count_q;
+endmodule
@@ -3,9 +3,8 @@
 
 Pipeline:
   1. Yosys: synthesise TMR version  (fi_counter_tmr.v)
-  2. patch_vl_macros.py: rename escaped voter module names so Verilator
-     can parse the generated Verilog
-  3. Verilator: elaborate plain model and TMR model
+  2. Verilator: elaborate plain model and TMR model
+  3. patch_vl_macros.py: replace port macros in the TMR model headers
   4. g++: compile plain testbench (sanity check)
   5. g++: compile TMR testbench   (fault injection)
   6. Run both testbenches
@@ -17,7 +16,6 @@ Exit code is the number of unmasked faults (0 = all faults masked).
 """
 
 import argparse
-import re
 import shutil
 import subprocess
 import sys
@@ -39,34 +37,6 @@ def run(cmd, *, cwd=None, check=True, label=None):
     return result
 
 
-def _patch_voter_names(verilog_path: pathlib.Path) -> None:
-    """Replace escaped Verilog voter identifiers with short plain names.
-
-    Yosys emits voter module names like:
-        \\tmrx_voter_..._$auto$file.cc:298:func$N_..._w1
-    These escaped identifiers contain '$', ':' and '.' which cause Verilator
-    to hash the name differently for the definition vs. the instance reference,
-    producing "Can't resolve module reference" errors.
-    """
-    content = verilog_path.read_text()
-    pat = re.compile(r'\\tmrx_voter_\S+')
-    name_map: dict[str, str] = {}
-    counter = 0
-
-    def _replace(m: re.Match) -> str:
-        nonlocal counter
-        orig = m.group(0)
-        if orig not in name_map:
-            name_map[orig] = f"tmrx_voter_{counter}"
-            counter += 1
-        return name_map[orig]
-
-    patched = pat.sub(_replace, content)
-    if patched != content:
-        verilog_path.write_text(patched)
-        print(f"  renamed {len(name_map)} escaped voter module name(s) in {verilog_path.name}")
-
-
 def main():
     p = argparse.ArgumentParser(description=__doc__)
     p.add_argument("--yosys",        required=True)
@@ -132,12 +102,7 @@ def main():
         run([yosys, "-ql", workdir / "synth.log", "-s", synth_ys], label="yosys/tmr")
 
         # ----------------------------------------------------------------
-        # 2. Rename escaped voter module names so Verilator can parse them
-        # ----------------------------------------------------------------
-        _patch_voter_names(tmr_v)
-
-        # ----------------------------------------------------------------
-        # 3. Verilator: elaborate plain model
+        # 2. Verilator: elaborate plain model
         # ----------------------------------------------------------------
         obj_plain.mkdir(exist_ok=True)
         run([
@@ -146,7 +111,7 @@ def main():
         ], label="verilator/plain")
 
         # ----------------------------------------------------------------
-        # 4. Verilator: elaborate TMR model
+        # 3. Verilator: elaborate TMR model
         # ----------------------------------------------------------------
         obj_tmr.mkdir(exist_ok=True)
         run([
@@ -161,7 +126,7 @@ def main():
         run([sys.executable, patch_py] + tmr_headers, label="patch_vl_macros")
 
         # ----------------------------------------------------------------
-        # 5. Compile plain testbench (sanity check, no fault injection)
+        # 4. Compile plain testbench (sanity check, no fault injection)
         # ----------------------------------------------------------------
         tb_plain_bin = workdir / "tb_plain"
         plain_cpps = sorted(obj_plain.glob(f"V{top}*.cpp"))
@@ -176,7 +141,7 @@ def main():
         ], label="g++/plain")
 
         # ----------------------------------------------------------------
-        # 6. Compile TMR testbench (direct register access, no vrtlmod)
+        # 5. Compile TMR testbench (direct register access, no vrtlmod)
         # ----------------------------------------------------------------
         tb_tmr_bin = workdir / "tb_tmr"
         tmr_cpps = sorted(obj_tmr.glob(f"V{top}*.cpp"))
@@ -192,7 +157,7 @@ def main():
         ], label="g++/tmr")
 
         # ----------------------------------------------------------------
-        # 7. Compile plain fault-injection testbench
+        # 6. Compile plain fault-injection testbench
         # ----------------------------------------------------------------
         tb_plain_fi_bin = workdir / "tb_plain_fi"
         run([
@@ -207,7 +172,7 @@ def main():
         ], label="g++/plain-fi")
 
         # ----------------------------------------------------------------
-        # 8. Compile TMR sanity testbench (no fault injection, TMR model)
+        # 7. Compile TMR sanity testbench (no fault injection, TMR model)
         # ----------------------------------------------------------------
         tb_tmr_sanity_bin = workdir / "tb_tmr_sanity"
         run([
@@ -222,7 +187,7 @@ def main():
         ], label="g++/tmr-sanity")
 
         # ----------------------------------------------------------------
-        # 10. Sanity-check plain model (no fault injection)
+        # 8. Sanity-check plain model (no fault injection)
         # ----------------------------------------------------------------
         rc = run([tb_plain_bin,
                   "--duration",   str(args.duration),
@@ -233,7 +198,7 @@ def main():
             sys.exit(rc)
 
         # ----------------------------------------------------------------
-        # 11. Run selected experiment and propagate its exit code
+        # 9. Run selected experiment and propagate its exit code
         # ----------------------------------------------------------------
         if args.mode == "tmr-fi":
             rc = run([tb_tmr_bin,
@@ -0,0 +1,18 @@
+// Simple 8-bit counter used as the DUT for the word-level voter test.
+// TMRX runs before techmap, so the counter register is still a single
+// 8-bit FF cell and each voting site is covered by one 8-bit voter.
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire       en_i,
+    output reg  [7:0] count_o,
+    (* tmrx_error_sink *)
+    output wire       err_o
+);
+    always @(posedge clk_i) begin
+        if (!rst_ni)
+            count_o <= 8'd0;
+        else if (en_i)
+            count_o <= count_o + 1'd1;
+    end
+endmodule
@@ -0,0 +1,18 @@
+// Width-parametric majority voter for use as a word-level TMRX voter cell.
+// Interface matches the word-level TMRX voter contract:
+//   a, b, c  – three redundant copies of the WIDTH-bit input
+//   y        – bitwise majority-voted output
+//   err      – single bit, set when any two copies disagree in any bit
+// WIDTH must default to 1 so the template also satisfies the 1-bit contract.
+module param_voter #(
+    parameter WIDTH = 1
+) (
+    input  wire [WIDTH-1:0] a,
+    input  wire [WIDTH-1:0] b,
+    input  wire [WIDTH-1:0] c,
+    output wire [WIDTH-1:0] y,
+    output wire             err
+);
+    assign y   = (a & b) | (a & c) | (b & c);
+    assign err = |((a ^ b) | (b ^ c));
+endmodule
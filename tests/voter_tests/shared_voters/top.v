@@ -0,0 +1,32 @@
+// One triplicated counter feeding two preserved-port submodule instances and
+// two output ports: every destination votes the same input triple.
+module sink (
+    input  wire [3:0] d_i,
+    input  wire [3:0] k_i,
+    output wire [3:0] y_o
+);
+    assign y_o = d_i ^ k_i;
+endmodule
+
+module top (
+    input  wire       clk_i,
+    input  wire       rst_ni,
+    input  wire       en_i,
+    input  wire [3:0] k_i,
+    output wire [3:0] a_o,
+    output wire [3:0] b_o,
+    output wire [3:0] c_o,
+    output wire [3:0] d_o
+);
+    reg [3:0] count_q;
+
+    always @(posedge clk_i or negedge rst_ni)
+        if (!rst_ni) count_q <= 4'h0;
+        else if (en_i) count_q <= count_q + 4'h1;
+
+    sink u_sink0 (.d_i(count_q), .k_i(k_i), .y_o(c_o));
+    sink u_sink1 (.d_i(count_q), .k_i(k_i), .y_o(d_o));
+
+    assign a_o = count_q;
+    assign b_o = count_q;
+endmodule